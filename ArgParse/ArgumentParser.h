@@ -4,19 +4,31 @@
 #include <algorithm>
 #include <numeric>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <map>
+#include <unordered_map>
 #include <sstream>
 #include <type_traits>
 #include <memory>
+#include <memory_resource>
 #include <functional>
 #include <limits>
 #include <optional>
+#include <any>
+#include <deque>
 #include <type_traits>
 #include <iomanip>
+#include <iterator>
+#include <ostream>
 #include <cassert>
+#include <mutex>
 //----------------------------------------------------------------------------
 #include "StringUtils.h"
 #include "TypeUtils.h"
+#include "ParseStats.h"
+#include "OptionTrie.h"
+#include "BkTree.h"
 //----------------------------------------------------------------------------
 namespace ArgParse
 {
@@ -35,6 +47,23 @@ template <typename String>
 using StringContainer= std::vector<String>;
 
 enum class ArgType{ invalid, positional, optional };
+
+// kind of command line token, assigned once by ArgumentParser::classify
+enum class TokenKind: unsigned char { value, option, subParser, separator };
+
+// parse error, one per exception type
+enum class ErrorCode
+{
+  none,
+  wrongCount,            // WrongCountException
+  invalidChoice,         // InvalidChoiceException
+  unrecognizedArguments, // UnrecognizedArgumentsException
+  argumentRequired,      // ArgumentRequiredException
+  outOfRange,            // OutOfRangeException
+  invalidArgument,       // InvalidArgumentException
+  lengthError,           // LengthErrorException
+  ambiguousOption        // AmbiguousOptionException
+};
 //----------------------------------------------------------------------------
 // pre define for friend access
 
@@ -43,15 +72,278 @@ class ArgumentParser;
 
 template<typename T, TypeGroup group, typename CharT>
 class Arg;
+
+template<typename T, TypeGroup group, typename CharT>
+class ArgImpl;
+
+template<typename CharT>
+class ArgInfo;
+//----------------------------------------------------------------------------
+//                      ParseResult
+//----------------------------------------------------------------------------
+// Values of one parse. Parsing into a ParseResult does not modify
+// the parser, so one parser can be shared by several threads,
+// each thread parsing into its own result.
+template<typename CharT>
+class ParseResult
+{
+public:
+  bool exists(const ArgInfo<CharT>& arg)const;
+  bool exists(const ArgumentParser<CharT>& parser)const;
+
+  // all args and parsers become not existing,
+  // slots of the previous epoch are cleared by their next use
+  void clear()
+  {
+    ++epoch_;
+    raw_.clear();
+    text_.clear();
+    stats_.clear();
+  }
+
+  // phases of the last parse, see ARGPARSE_INSTRUMENTATION
+  const ParseStats& stats()const{ return stats_; }
+
+private:
+  template<typename T, TypeGroup group, typename C>
+  friend class ArgImpl;
+  friend ArgInfo<CharT>;
+  friend ArgumentParser<CharT>;
+
+  static constexpr const std::size_t npos= std::size_t(-1);
+
+  // one slot per arg and per (sub) parser, slot ids are given by the parser
+  struct Slot
+  {
+    std::size_t epoch= 0; // ParseResult::epoch_ of the last use
+    bool exists= false;
+    // ArgImpl::StorageType, kept by the next epochs for its buffers,
+    // hasValue tells if it is the value of the current epoch
+    mutable std::any value;
+    mutable bool hasValue= false;
+
+    // lazy conversion: not converted tokens, list of raw_ items,
+    // converted by the first read of value
+    mutable std::size_t rawFirst= npos;
+    std::size_t rawLast= npos;
+  };
+
+  struct RawToken
+  {
+    std::basic_string_view<CharT> token;
+    std::size_t next;
+  };
+
+  // nullptr for the slots of previous epochs
+  const Slot* slot(std::size_t id)const
+  {
+    return id<slots_.size() && slots_[id].epoch==epoch_ ? &slots_[id] : nullptr;
+  }
+
+  bool slotExists(std::size_t id)const
+  {
+    const Slot* s= slot(id);
+    return s && s->exists;
+  }
+
+  Slot& slot(std::size_t id)
+  {
+    if(id>=slots_.size())
+      slots_.resize(id+1);
+
+    Slot& s= slots_[id];
+    if(s.epoch!=epoch_)
+    {
+      s.epoch= epoch_;
+      s.exists= false;
+      s.hasValue= false;
+      s.rawFirst= s.rawLast= npos;
+    }
+    return s;
+  }
+
+  void reserve(std::size_t slotCount)
+  {
+    if(slots_.size()<slotCount)
+      slots_.resize(slotCount);
+  }
+
+  void reset(std::size_t id)
+  {
+    if(id<slots_.size())
+      slots_[id].epoch= epoch_-1;
+  }
+
+  void appendRaw(std::size_t id, std::basic_string_view<CharT> token)
+  {
+    Slot& s= slot(id);
+    const std::size_t index= raw_.size();
+    raw_.push_back({token,npos});
+    if(s.rawFirst==npos)
+      s.rawFirst= index;
+    else
+      raw_[s.rawLast].next= index;
+    s.rawLast= index;
+  }
+
+  void clearRaw(std::size_t id){ slot(id).rawFirst= npos; }
+
+  using StringView= std::basic_string_view<CharT>;
+
+  // copy of tokens owned by the result, for lazy conversion;
+  // the raw tokens of the previous parses are compacted to the new text,
+  // the rest of the previous text is dropped
+  const std::vector<StringView>& keepTokens(const StringView* tokens,
+                                            std::size_t count)
+  {
+    std::size_t length= 0;
+    for(std::size_t i=0; i<count; ++i)
+      length+= tokens[i].size();
+    for(const Slot& s: slots_)
+    {
+      if(s.epoch==epoch_)
+        for(std::size_t i=s.rawFirst; i!=npos; i=raw_[i].next)
+          length+= raw_[i].token.size();
+    }
+
+    // no reallocation, the views stay valid
+    spareText_.clear();
+    spareText_.reserve(length);
+    const auto keep= [this](StringView token)
+    {
+      const std::size_t first= spareText_.size();
+      spareText_.insert(spareText_.end(),token.begin(),token.end());
+      return StringView(spareText_.data()+first,token.size());
+    };
+
+    spareRaw_.clear();
+    for(Slot& s: slots_)
+    {
+      if(s.epoch!=epoch_ || s.rawFirst==npos)
+        continue;
+
+      std::size_t i= s.rawFirst;
+      s.rawFirst= spareRaw_.size();
+      for(; i!=npos; i=raw_[i].next)
+        spareRaw_.push_back({keep(raw_[i].token),spareRaw_.size()+1});
+      spareRaw_.back().next= npos;
+      s.rawLast= spareRaw_.size()-1;
+    }
+
+    kept_.clear();
+    for(std::size_t i=0; i<count; ++i)
+      kept_.push_back(keep(tokens[i]));
+
+    // vectors keep the addresses of their items by swap
+    raw_.swap(spareRaw_);
+    text_.swap(spareText_);
+    return kept_;
+  }
+
+  std::vector<Slot> slots_;
+  std::size_t epoch_= 1;
+  std::vector<RawToken> raw_;
+  std::vector<CharT> text_;  // of the raw tokens
+  std::vector<StringView> kept_;
+  std::vector<RawToken> spareRaw_; // buffers of keepTokens()
+  std::vector<CharT> spareText_;
+  std::vector<TokenKind> kinds_; // of the tokens, kept for the next parses
+  ParseStats stats_;
+};
+//----------------------------------------------------------------------------
+namespace detail
+{
+// converts str and stores it to the slot of arg in result,
+// ArgImpl<T,group,CharT>::convert of the registered type of arg
+template<typename CharT>
+using ConvertFunction= ErrorCode(*)(const ArgInfo<CharT>& arg,
+                                    std::basic_string_view<CharT> str,
+                                    ParseResult<CharT>& result);
+
+// fields of an arg read by the parse
+template<typename CharT>
+struct ArgRecord
+{
+  std::size_t minCount= 0;
+  std::size_t maxCount= std::numeric_limits<std::size_t>::max();
+  const ArgInfo<CharT>* info= nullptr; // nullptr for parsers
+  ConvertFunction<CharT> convert= nullptr;
+  bool required= false;
+};
+
+// shared by a parser, its sub parsers and args
+template<typename CharT>
+struct ParserTree
+{
+  explicit ParserTree(std::pmr::memory_resource* resource)
+    :resource(resource),
+     args(resource),
+     freeSlots(resource)
+  {}
+
+  // the slots of removed args are taken first
+  std::size_t newSlot()
+  {
+    if(!freeSlots.empty())
+    {
+      const std::size_t slot= freeSlots.back();
+      freeSlots.pop_back();
+      return slot;
+    }
+    args.emplace_back();
+    return slotCount++;
+  }
+
+  // the values of the slot in the results must be reset
+  void freeSlot(std::size_t slot)
+  {
+    args[slot]= ArgRecord<CharT>();
+    freeSlots.push_back(slot);
+  }
+  void modified(){ ++revision; }
+
+  // args, sub parsers and lookup tables of the tree
+  std::pmr::memory_resource* resource;
+
+  // parse time data of the args indexed by slot, kept contiguous
+  // for the parse loop, names and help texts stay in ArgInfo
+  std::pmr::vector<ArgRecord<CharT>> args;
+  std::pmr::vector<std::size_t> freeSlots; // of removed args
+
+  std::size_t slotCount= 0;
+  std::size_t revision= 0;   // changes of the schema, invalidate help texts
+  bool lazy= false;          // ArgumentParser::setLazyConversion
+  ParseResult<CharT> result; // used by parseArgs() without result
+  std::mutex suggestionMutex;// builds of SuggestionIndex
+  std::mutex textMutex;      // builds of the help and usage texts
+};
+//----------------------------------------------------------------------------
+// "did you mean" lookup of a parser, built by the first error
+// after a change of the schema
+template<typename CharT>
+struct SuggestionIndex
+{
+  std::size_t revision= 0;
+  BkTree<CharT> options;     // option strings
+  BkTree<CharT> subParsers;  // sub parser names
+};
+
+// friend of ArgInfo, defined by the tests and benchmarks
+// that call the conversion of an arg directly
+template<typename CharT>
+struct ArgConversion;
+} // end namespace detail
 //----------------------------------------------------------------------------
 //                      ArgInfo
 //----------------------------------------------------------------------------
 template<typename CharT>
 class ArgInfo
+    : public std::enable_shared_from_this<ArgInfo<CharT>>
 {
 public:
   using String  = std::basic_string<CharT>;
   using Strings = StringContainer<String>;
+  using StringView = std::basic_string_view<CharT>;
 
   virtual ~ArgInfo()=default;
 
@@ -61,24 +353,39 @@ public:
   const String& name()const{ return name_;}
   const String fullName()const;
 
-  bool isRequired()const{ return required_; }
-  void setRequired(bool required){ required_= required; }
+  bool isRequired()const{ return tree_->args[slot_].required; }
+  void setRequired(bool required){ tree_->args[slot_].required= required; }
 
   const String& help()const { return help_;  }
-  void setHelp(const String& help){ help_= help; }
+  void setHelp(const String& help)
+  {
+    help_= help;
+    if(tree_)
+      tree_->modified();
+  }
+
+  std::size_t maxCount()const{ return tree_->args[slot_].maxCount; }
+  std::size_t minCount()const{ return tree_->args[slot_].minCount; }
+
+  bool exists()const { return exists(tree_->result); }
+  bool exists(const ParseResult<CharT>& result)const
+  {
+    return result.exists(*this);
+  }
+
+  String valueAsString()const{ return valueAsString(tree_->result); }
+  bool hasValue()const{ return hasValue(tree_->result); }
 
-  std::size_t maxCount()const{ return maxCount_; }
-  std::size_t minCount()const{ return minCount_; }
+  void reset(){ reset(tree_->result); }
+  void reset(ParseResult<CharT>& result)const{ result.reset(slot_); }
 
-  bool exists()const { return exists_; }
   // purely virtual
 
-  virtual String valueAsString()const= 0;
+  virtual String valueAsString(const ParseResult<CharT>& result)const= 0;
   virtual String maxValueAsString()const= 0;
   virtual String minValueAsString()const= 0;
 
-  virtual bool hasValue()const= 0;
-  virtual void reset()= 0;
+  virtual bool hasValue(const ParseResult<CharT>& result)const= 0;
 
   virtual std::size_t typeId()const= 0;
   virtual const char* typeName()const= 0;
@@ -86,22 +393,29 @@ public:
 
 protected:
   friend ArgumentParser<CharT>;
+  friend ParseResult<CharT>;
+  friend detail::ArgConversion<CharT>;
 
   ArgType argType_= ArgType::invalid;
   Strings optionStrings_;
   String  name_;
 
-  bool required_= false;
   String help_;
 
-  std::size_t minCount_= 0;
-  std::size_t maxCount_= std::numeric_limits<std::size_t>::max();
-  bool exists_ = false;
+  std::size_t slot_= 0;
+  std::shared_ptr<detail::ParserTree<CharT>> tree_;
 
-  virtual void assingOrAppendFromString(const String& str)= 0;
+  virtual ErrorCode assingOrAppendFromString(StringView str,
+                                             ParseResult<CharT>& result)const= 0;
 };
 //---------------------------------------------------------------------------------------
 template<typename CharT>
+bool ParseResult<CharT>::exists(const ArgInfo<CharT>& arg)const
+{
+  return slotExists(arg.slot_);
+}
+//---------------------------------------------------------------------------------------
+template<typename CharT>
 const typename ArgInfo<CharT>::String ArgInfo<CharT>::fullName()const
 {
   using StringUtils::join;
@@ -124,6 +438,7 @@ public:
   using Base= ArgInfo<CharT>;
   using typename Base::String;
   using typename Base::Strings;
+  using typename Base::StringView;
   using StringsConstIter= typename Base::Strings::const_iterator;
 
   using RangeValueType =
@@ -145,48 +460,58 @@ public:
                                               >
                           >;
 
-  ValueType storage()const
+  using Base::valueAsString;
+  using Base::hasValue;
+
+  ValueType value(const ParseResult<CharT>& result)const
   {
     if constexpr(isSequence)
-      return storage_;
+      return storage(result);
     else
-      return *storage_;
-  };
+      return *storage(result);
+  }
 
+  ValueType storage()const
+  {
+    return value(this->tree_->result);
+  };
 
   void assign(ValueType value)
   {
-    storage_= value;
+    mutableStorage(this->tree_->result)= value;
   }
 
   // ArgInfo
 
-  virtual void reset() override
+  virtual ErrorCode assingOrAppendFromString(StringView str,
+                                             ParseResult<CharT>& result)const override;
+
+  // converts str and checks the range
+  ErrorCode fromString(StringView str, T& value)const;
+
+  // ConvertFunction of the parse, arg is an ArgImpl of this type
+  static ErrorCode convert(const ArgInfo<CharT>& arg,
+                           StringView str,
+                           ParseResult<CharT>& result)
   {
-    this->exists_= false;
-    if constexpr(isSequence)
-      storage_.clear();
-    else
-      storage_.reset();
+    return static_cast<const ArgImpl&>(arg).ArgImpl::assingOrAppendFromString(str,result);
   }
 
-  virtual void assingOrAppendFromString(const String& str)override;
-
   virtual std::size_t typeId()const   override{ return TypeInfo<T>::id; }
   virtual const char* typeName()const override{ return TypeInfo<T>::name; }
   virtual TypeGroup typeGroup()const  override{ return group; }
 
-  virtual String valueAsString()const override
+  virtual String valueAsString(const ParseResult<CharT>& result)const override
   {
     using namespace StringUtils;
     if constexpr(group==TypeGroup::number)
-      return toString<CharT>(storage());
+      return toString<CharT>(value(result));
     else if constexpr(group==TypeGroup::numbers)
-      return joinF<String>(storage_,", ",toString<CharT,T>,false);
+      return joinF<String>(storage(result),", ",toString<CharT,T>,false);
     else if constexpr(group==TypeGroup::strings)
-      return join(storage(),", ",'\"','\"',false);
+      return join(value(result),", ",'\"','\"',false);
     else
-      return storage();
+      return value(result);
   }
 
   virtual String minValueAsString()const override
@@ -199,12 +524,16 @@ public:
     return StringUtils::toString<CharT>(range_.second);
   }
 
-  virtual bool hasValue()const override
+  virtual bool hasValue(const ParseResult<CharT>& result)const override
   {
+    const auto* slot= result.slot(this->slot_);
+    if(slot && slot->rawFirst!=ParseResult<CharT>::npos)
+      return true;
+
     if constexpr(isSequence)
-      return !storage_.empty();
+      return !storage(result).empty();
     else
-      return storage_.has_value();
+      return storage(result).has_value();
   }
 
 private:
@@ -212,30 +541,121 @@ private:
       std::make_pair(std::numeric_limits<RangeValueType>::lowest(),
                      std::numeric_limits<RangeValueType>::max());
 
-  StorageType storage_;
+  using Slot= typename ParseResult<CharT>::Slot;
+
+  // empty storage if the result has no value for this arg,
+  // raw tokens of lazy conversion are converted here,
+  // which writes to the result (see setLazyConversion)
+  const StorageType& storage(const ParseResult<CharT>& result)const
+  {
+    static const StorageType empty{};
+    const auto* slot= result.slot(this->slot_);
+    if(!slot)
+      return empty;
+
+    if(slot->rawFirst!=ParseResult<CharT>::npos)
+      convertRaw(result,*slot);
+
+    const StorageType* storage=
+        slot->hasValue ? std::any_cast<StorageType>(&slot->value) : nullptr;
+    return storage ? *storage : empty;
+  }
+
+  // throws ValueException<CharT> subclasses
+  void convertRaw(const ParseResult<CharT>& result, const Slot& slot)const;
+  void throwValueError(ErrorCode error, StringView str)const;
+
+  StorageType& mutableStorage(ParseResult<CharT>& result)const
+  {
+    Slot& slot= result.slot(this->slot_);
+    StorageType* storage= std::any_cast<StorageType>(&slot.value);
+    if(!storage)
+      storage= &slot.value.template emplace<StorageType>();
+    else if(!slot.hasValue)
+    {
+      // value of a previous epoch, its buffers are reused
+      if constexpr(isSequence)
+        storage->clear();
+      else
+        *storage= StorageType();
+    }
+    slot.hasValue= true;
+    return *storage;
+  }
 };
 //---------------------------------------------------------------------------------------
 template< typename T, TypeGroup group, typename CharT>
-void ArgImpl<T, group, CharT>::
-   assingOrAppendFromString(const String& str)
-
+ErrorCode ArgImpl<T, group, CharT>::fromString(StringView str, T& value)const
 {
-  const T value = TypeInfo<T>::assignFromString(str);
+  const std::errc ec= TypeInfo<T>::tryAssignFromString(str,value);
+  if(ec==std::errc::result_out_of_range)
+    return ErrorCode::outOfRange;
+  if(ec!=std::errc())
+    return ErrorCode::invalidArgument;
+
   if constexpr(group==TypeGroup::string || group==TypeGroup::strings)
   {
     if(value.length() < range_.first || value.length() > range_.second)
-      throw std::length_error("length error");
+      return ErrorCode::lengthError;
   }
   else
   {
     if(value< range_.first || value> range_.second)
-       throw std::range_error("range error");
+      return ErrorCode::outOfRange;
   }
+  return ErrorCode::none;
+}
+//---------------------------------------------------------------------------------------
+template< typename T, TypeGroup group, typename CharT>
+ErrorCode ArgImpl<T, group, CharT>::
+   assingOrAppendFromString(StringView str, ParseResult<CharT>& result)const
+
+{
+  T value{};
+  const ErrorCode error= fromString(str,value);
+  if(error!=ErrorCode::none)
+    return error;
 
   if constexpr(group==TypeGroup::number || group==TypeGroup::string)
-    this->storage_= value;
+    mutableStorage(result)= std::move(value);
   else
-    this->storage_.push_back(value);
+    mutableStorage(result).push_back(std::move(value));
+  return ErrorCode::none;
+}
+//---------------------------------------------------------------------------------------
+template< typename T, TypeGroup group, typename CharT>
+void ArgImpl<T, group, CharT>::convertRaw(const ParseResult<CharT>& result,
+                                          const Slot& slot)const
+{
+  // nothing is stored if a token is invalid, the next read throws again
+  StorageType converted;
+  for(std::size_t i=slot.rawFirst; i!=ParseResult<CharT>::npos; i=result.raw_[i].next)
+  {
+    const StringView str= result.raw_[i].token;
+    T value{};
+    const ErrorCode error= fromString(str,value);
+    if(error!=ErrorCode::none)
+      throwValueError(error,str);
+
+    if constexpr(isSequence)
+      converted.push_back(std::move(value));
+    else
+      converted= std::move(value);
+  }
+
+  StorageType* storage=
+      slot.hasValue ? std::any_cast<StorageType>(&slot.value) : nullptr;
+  slot.hasValue= true;
+  if(!storage)
+    slot.value= std::move(converted);
+  else if constexpr(isSequence)
+    storage->insert(storage->end(),
+                    std::make_move_iterator(converted.begin()),
+                    std::make_move_iterator(converted.end()));
+  else
+    *storage= std::move(converted);
+
+  slot.rawFirst= ParseResult<CharT>::npos;
 }
 //---------------------------------------------------------------------------------------
 //             BaseArg
@@ -249,11 +669,19 @@ public:
   using RangeValueType= typename Impl::RangeValueType;
   using String= std::basic_string<CharT>;
 
-  explicit BaseArg(std::shared_ptr<Impl> impl):impl_(impl){}
+  explicit BaseArg(std::shared_ptr<Impl> impl):impl_(std::move(impl)){}
 
   bool exists()const   { return impl_->exists();   }
+  bool exists(const ParseResult<CharT>& result)const
+  {
+    return impl_->exists(result);
+  }
 
   bool hasValue()const { return impl_->hasValue(); }
+  bool hasValue(const ParseResult<CharT>& result)const
+  {
+    return impl_->hasValue(result);
+  }
   operator bool()const { return hasValue(); }
 
   ValueType operator*()const    { return   impl_->storage(); }
@@ -287,13 +715,18 @@ class Arg<T, TypeGroup::numbers, CharT>
   using typename Base::ValueType;
 
 public:
-  explicit Arg(std::shared_ptr<typename Base::Impl> impl):Base(impl){}
+  explicit Arg(std::shared_ptr<typename Base::Impl> impl):Base(std::move(impl)){}
 
   ValueType values()const
   {
     return this->impl_->storage();
   }
 
+  ValueType values(const ParseResult<CharT>& result)const
+  {
+    return this->impl_->value(result);
+  }
+
   Arg& operator=(ValueType value)
   {
     this->impl_->assign(value);
@@ -315,13 +748,18 @@ class Arg<T,TypeGroup::strings,CharT>
   using typename Base::ValueType;
 
 public:
-  explicit Arg(std::shared_ptr<typename Base::Impl> impl):Base(impl){}
+  explicit Arg(std::shared_ptr<typename Base::Impl> impl):Base(std::move(impl)){}
 
   ValueType values()const
   {
     return this->impl_->storage();
   }
 
+  ValueType values(const ParseResult<CharT>& result)const
+  {
+    return this->impl_->value(result);
+  }
+
   Arg& operator=(ValueType value)
   {
     this->impl_->assign(value);
@@ -348,13 +786,18 @@ class Arg<T,TypeGroup::number,CharT>
   using typename Base::ValueType;
 
 public:
-  explicit Arg(std::shared_ptr<typename Base::Impl> impl):Base(impl){}
+  explicit Arg(std::shared_ptr<typename Base::Impl> impl):Base(std::move(impl)){}
 
   ValueType value()const
   {
     return this->impl_->storage();
   }
 
+  ValueType value(const ParseResult<CharT>& result)const
+  {
+    return this->impl_->value(result);
+  }
+
   Arg& operator=(ValueType value)
   {
     this->impl_->assign(value);
@@ -377,13 +820,18 @@ class Arg<T,TypeGroup::string,CharT>
   using typename Base::ValueType;
 
 public:
-  explicit Arg(std::shared_ptr<typename Base::Impl> impl):Base(impl){}
+  explicit Arg(std::shared_ptr<typename Base::Impl> impl):Base(std::move(impl)){}
 
   ValueType value()const
   {
     return this->impl_->storage();
   }
 
+  ValueType value(const ParseResult<CharT>& result)const
+  {
+    return this->impl_->value(result);
+  }
+
   Arg& operator=(ValueType value)
   {
     this->impl_->assign(value);
@@ -455,7 +903,7 @@ auto optionName(const StringContainer<String>& optionStrings,
   for(const auto& s:optionStrings)
   {
     auto it =
-      find_if_not(begin(s),next(begin(s),std::min(2u,size(s))),
+      find_if_not(begin(s),next(begin(s),std::min<size_t>(2u,size(s))),
         [&prefixChars](auto c)
         {
           return prefixChars.find(c)!= String::npos;
@@ -472,56 +920,77 @@ auto optionName(const StringContainer<String>& optionStrings,
   return name;
 }
 //----------------------------------------------------------------
-template<typename CharT>
-auto makeUsage(const std::shared_ptr<ArgInfo<CharT>>& arg)
+template<typename CharT, typename OutputIt>
+OutputIt writeUsage(OutputIt out, const std::shared_ptr<ArgInfo<CharT>>& arg)
 {
   using namespace StringUtils::literals;
-  using StringUtils::repeatString;
+  using StringUtils::writeString;
+  using StringUtils::writeRepeated;
 
   if(arg->argType()==ArgType::optional)
   {
      assert(!arg->optionStrings().empty());
 
-     return "["_lv +
-               arg->optionStrings().front()
-               +" "_lv
-               +repeatString(arg->name(),arg->minCount())+
-               "]"_lv;
+     out= writeString(out,"["_lv);
+     out= writeString(out,arg->optionStrings().front());
+     out= writeString(out," "_lv);
+     out= writeRepeated(out,arg->name(),arg->minCount());
+     return writeString(out,"]"_lv);
   }
   else
   {
-    return repeatString(arg->name(),arg->minCount());
+    return writeRepeated(out,arg->name(),arg->minCount());
   }
 }
 //-----------------------------------------------------------------------
-template<typename CharT>
-auto makeHelpLine(const std::shared_ptr<ArgInfo<CharT>>& arg)
+template<typename CharT, typename OutputIt>
+OutputIt writeHelpLine(OutputIt out, const std::shared_ptr<ArgInfo<CharT>>& arg)
 {
   using namespace StringUtils::literals;
-  using String = std::basic_string<CharT>;
-  using StringUtils::repeatString;
-  using StringUtils::appendJoinedF;
+  using StringUtils::writeString;
+  using StringUtils::writeRepeated;
 
-  String helpLine;
   if(arg->argType()==ArgType::positional)
   {
-     helpLine += arg->name();
+     out= writeString(out,arg->name());
   }
   else if(arg->argType()==ArgType::optional)
   {
-    appendJoinedF(helpLine, arg->optionStrings(),", ",
-      [arg](const auto& optionString)
-       {
-         return optionString+" "_lv+
-                repeatString(arg->name(),arg->minCount());
-       });
+    bool first= true;
+    for(const auto& optionString: arg->optionStrings())
+    {
+      if(!first)
+        out= writeString(out,", "_lv);
+      first= false;
+
+      out= writeString(out,optionString);
+      out= writeString(out," "_lv);
+      out= writeRepeated(out,arg->name(),arg->minCount());
+    }
   }
   if(!arg->help().empty())
-    helpLine += " "_lv+ arg->help();
-
-  return helpLine;
+  {
+    out= writeString(out," "_lv);
+    out= writeString(out,arg->help());
+  }
+  return out;
 }
+//----------------------------------------------------------------------------
+// ostreams are passed by reference, not as output iterators
+template<typename OutputIt>
+using EnableIfNotStream=
+    std::enable_if_t<!std::is_base_of_v<std::ios_base,OutputIt>,int>;
 //----------------------------------------------------------------------------------
+template<typename String>
+String didYouMean(const StringContainer<String>& suggestions)
+{
+  using namespace StringUtils::literals;
+  using StringUtils::join;
+  if(suggestions.empty())
+    return String();
+  return "; did you mean "_lv+join(suggestions,", ",'\'','\'')+"?"_lv;
+}
+//----------------------------------------------------------------------------
 } // end namespace detail
 //----------------------------------------------------------------------------------
 //                        Exception<CharT>
@@ -577,10 +1046,12 @@ public:
   using ArgInfoPtr= typename Exception<CharT>::ArgInfoPtr;
 
   InvalidChoiceException(const String& value,
-                         const Strings& possibleChoice)
+                         const Strings& possibleChoice,
+                         const Strings& suggestions= Strings())
     :Exception<CharT>(),
      value_(value),
-     possibleChoice_(possibleChoice)
+     possibleChoice_(possibleChoice),
+     suggestions_(suggestions)
   {
   }
 
@@ -591,15 +1062,19 @@ public:
     using StringUtils::join;
     return
       "invalid choice: '"_lv+value_+"' "
-      "(choose from "_lv+join(possibleChoice_,", ",'\'','\'')+")"_lv;
+      "(choose from "_lv+join(possibleChoice_,", ",'\'','\'')+")"_lv+
+      detail::didYouMean(suggestions_);
   }
 
   const String&  value()const{ return value_; }
   const Strings& possibleChoice()const{ return possibleChoice_; }
+  // option strings or choices close to the value, nearest first
+  const Strings& suggestions()const{ return suggestions_; }
 
 private:
   String value_;
   Strings possibleChoice_;
+  Strings suggestions_;
 };
 //----------------------------------------------------------------------------------
 template <typename CharT>
@@ -609,9 +1084,11 @@ public:
   using String= typename Exception<CharT>::String;
   using Strings= StringContainer<String>;
 
-  explicit UnrecognizedArgumentsException(const Strings& values)
+  explicit UnrecognizedArgumentsException(const Strings& values,
+                                          const Strings& suggestions= Strings())
     :Exception<CharT>(),
-     values_(values)
+     values_(values),
+     suggestions_(suggestions)
   {
   }
 
@@ -619,13 +1096,50 @@ public:
   {
     using namespace StringUtils::literals;
     using StringUtils::join;
-    return "unrecognized arguments: "_lv +join(values_,", ",'\'','\'');
+    return "unrecognized arguments: "_lv +join(values_,", ",'\'','\'')+
+           detail::didYouMean(suggestions_);
   }
 
   const Strings& values()const{ return values_; }
+  // option strings or sub parser names close to the first value,
+  // nearest first
+  const Strings& suggestions()const{ return suggestions_; }
 
 private:
   Strings values_;
+  Strings suggestions_;
+};
+//----------------------------------------------------------------------------------
+template <typename CharT>
+class AmbiguousOptionException: public Exception<CharT>
+{
+public:
+  using String= typename Exception<CharT>::String;
+  using Strings= StringContainer<String>;
+
+  AmbiguousOptionException(const String& value,
+                           const Strings& candidates)
+    :Exception<CharT>(),
+     value_(value),
+     candidates_(candidates)
+  {
+  }
+
+  virtual String what()const override
+  {
+    using namespace StringUtils::literals;
+    using StringUtils::join;
+    return
+      "ambiguous option: '"_lv+value_+"' "
+      "could match "_lv+join(candidates_,", ",'\'','\'');
+  }
+
+  const String&  value()const{ return value_; }
+  const Strings& candidates()const{ return candidates_; }
+
+private:
+  String value_;
+  Strings candidates_;
 };
 //----------------------------------------------------------------------------------
 template <typename CharT>
@@ -756,6 +1270,38 @@ public:
   }
 };
 //----------------------------------------------------------------------------
+template< typename T, TypeGroup group, typename CharT>
+void ArgImpl<T, group, CharT>::throwValueError(ErrorCode error,
+                                               StringView str)const
+{
+  const auto arg=
+      std::const_pointer_cast<ArgInfo<CharT>>(this->shared_from_this());
+
+  if(error==ErrorCode::outOfRange)
+    throw OutOfRangeException<CharT>(String(str),arg);
+  if(error==ErrorCode::lengthError)
+    throw LengthErrorException<CharT>(String(str),arg);
+  throw InvalidArgumentException<CharT>(String(str),arg);
+}
+//----------------------------------------------------------------------------
+//                        ParseStatus<CharT>
+//----------------------------------------------------------------------------
+// Result of ArgumentParser::tryParseXxx, nothing is thrown on errors
+template <typename CharT>
+struct ParseStatus
+{
+  static constexpr const std::size_t npos= std::size_t(-1);
+
+  ErrorCode error= ErrorCode::none;
+  std::size_t index= npos;  // offending token, npos for argumentRequired
+  std::size_t count= 0;     // offending tokens count from index
+  const ArgInfo<CharT>* arg= nullptr;            // offending arg if any
+  const ArgumentParser<CharT>* parser= nullptr;  // (sub) parser of the error
+
+  bool ok()const{ return error==ErrorCode::none; }
+  explicit operator bool()const{ return ok(); }
+};
+//----------------------------------------------------------------------------
 //                        ArgumentParser
 //----------------------------------------------------------------------------
 template <typename CharT>
@@ -764,12 +1310,28 @@ class ArgumentParser
 public:
   using String  = std::basic_string<CharT>;
   using Strings = StringContainer<String>;
+  using StringView = std::basic_string_view<CharT>;
+  using StringViews= StringContainer<StringView>;
+  using SplitBuffer= StringUtils::SplitBuffer<CharT>;
   using ArgInfoPtr= std::shared_ptr<ArgInfo<CharT>>;
   using ArgumentParserPtr= std::shared_ptr<ArgumentParser<CharT>>;
 
   explicit ArgumentParser(const String& prefixChars=
       StringUtils::LatinView("-/"))
-    :prefixChars_(prefixChars)
+    :ArgumentParser(std::pmr::get_default_resource(),prefixChars)
+  {}
+
+  // Args, sub parsers and option lookup tables are allocated from resource,
+  // e.g. std::pmr::monotonic_buffer_resource to free them in one shot.
+  // resource must outlive the parser and all Arg handles.
+  explicit ArgumentParser(std::pmr::memory_resource* resource,
+                          const String& prefixChars=
+                              StringUtils::LatinView("-/"))
+    :ArgumentParser(PrivateTag(),
+                    std::allocate_shared<detail::ParserTree<CharT>>(
+                      std::pmr::polymorphic_allocator<char>(resource),
+                      resource),
+                    prefixChars)
   {}
 
   virtual ~ArgumentParser()=default;
@@ -811,21 +1373,107 @@ public:
   Arg<T, TypeUtils::groupOfNArgs<T,nargs,CharT>(), CharT>
     addOptional(OptionStrings&& ... optionStrings);
 
+  // the slots of removed args are reused by the next args,
+  // results other than the parser's own must be reset
   void removeAllArguments();
   void removeSubParsers();
   void clear(){ removeAllArguments(); removeSubParsers(); }
 
-  void reset();
-  String help(bool recursive= false,std::size_t level=0)const;
-  String usage()const;
+  // constant time for the root parser, a sub parser resets its own args
+  void reset(){ reset(tree_->result); }
+  void reset(ParseResult<CharT>& result)const;
+
+  // texts are cached until the next change of the parser tree,
+  // the references stay valid until then; built under a lock,
+  // concurrent calls share them
+  const String& help(bool recursive= false,std::size_t level=0)const;
+  const String& usage()const;
+
+  // not cached texts written in fragments, no intermediate strings
+  template<typename OutputIt, detail::EnableIfNotStream<OutputIt> = 0>
+  OutputIt writeHelp(OutputIt out,
+                     bool recursive= false,std::size_t level=0)const;
+  template<typename OutputIt, detail::EnableIfNotStream<OutputIt> = 0>
+  OutputIt writeUsage(OutputIt out)const;
+
+  std::basic_ostream<CharT>& writeHelp(std::basic_ostream<CharT>& os,
+                                       bool recursive= false,
+                                       std::size_t level=0)const
+  {
+    writeHelp(std::ostreambuf_iterator<CharT>(os),recursive,level);
+    return os;
+  }
+
+  std::basic_ostream<CharT>& writeUsage(std::basic_ostream<CharT>& os)const
+  {
+    writeUsage(std::ostreambuf_iterator<CharT>(os));
+    return os;
+  }
 
+  // throw Exception<CharT> subclasses on errors
   void parseArgs(int argc, CharT *argv[]);
   void parseArgs(int argc, const CharT *argv[]);
   void parseArgs(const Strings& args);
+  void parseArgs(const StringViews& args);
   void parseCmdLine(const String& str);
+  // tokens are views of str or of buffer, buffer can be reused between calls
+  void parseCmdLine(StringView str, SplitBuffer& buffer);
+
+  // non-throwing, ParseStatus::index refers to args or to buffer.tokens()
+  ParseStatus<CharT> tryParseArgs(int argc, CharT *argv[]);
+  ParseStatus<CharT> tryParseArgs(int argc, const CharT *argv[]);
+  ParseStatus<CharT> tryParseArgs(const Strings& args);
+  ParseStatus<CharT> tryParseArgs(const StringViews& args);
+  ParseStatus<CharT> tryParseCmdLine(const String& str);
+  ParseStatus<CharT> tryParseCmdLine(StringView str, SplitBuffer& buffer);
+
+  // values go to result instead of the args,
+  // const methods can be called concurrently with distinct results
+  void parseArgs(const StringViews& args, ParseResult<CharT>& result)const;
+  void parseCmdLine(StringView str, SplitBuffer& buffer,
+                    ParseResult<CharT>& result)const;
+
+  ParseStatus<CharT> tryParseArgs(const StringViews& args,
+                                  ParseResult<CharT>& result)const;
+  ParseStatus<CharT> tryParseCmdLine(StringView str, SplitBuffer& buffer,
+                                     ParseResult<CharT>& result)const;
+
+  // throws the exception of a failed tryParseXxx,
+  // call for status.parser with the parsed tokens
+  void throwError(const ParseStatus<CharT>& status,
+                  const StringView* tokens)const;
+
+  // Values are converted by the first read instead of parseArgs(),
+  // conversion errors are thrown by the read. Tokens are copied to the
+  // ParseResult. Applies to the parser and all sub parsers.
+  // A read converts into the result: reads of one lazy result must
+  // not run concurrently, even through const methods.
+  void setLazyConversion(bool lazy){ tree_->lazy= lazy; }
+  bool lazyConversion()const{ return tree_->lazy; }
+
+  // Options given by a unique prefix of their long option string
+  // ("--verb" for "--verbose"), a prefix of several args is an
+  // ambiguousOption error. Applies to the options of this parser only.
+  void setAllowAbbrev(bool allow);
+  bool allowAbbrev()const{ return allowAbbrev_; }
+
+  // Unknown options and sub parser names are reported with up to count
+  // known ones, within maxDistance edits and a third of their length;
+  // count 0 turns suggestions off
+  void setSuggestions(std::size_t count, std::size_t maxDistance= 2)
+  {
+    suggestionCount_= count;
+    suggestionDistance_= maxDistance;
+  }
+  std::size_t suggestionCount()const{ return suggestionCount_; }
+  std::size_t suggestionDistance()const{ return suggestionDistance_; }
 
-  void setSubParserHelp(const String& help){ help_= help; };
-  bool exists() const { return exists_; }
+  void setSubParserHelp(const String& help){ help_= help; tree_->modified(); };
+  bool exists()const { return exists(tree_->result); }
+  bool exists(const ParseResult<CharT>& result)const
+  {
+    return result.exists(*this);
+  }
 
   const String& prefixChars()const{ return prefixChars_; }
   const String& name()const{ return name_; }
@@ -834,206 +1482,628 @@ public:
   const std::vector<ArgInfoPtr>& optionals()const   {return optionals_; }
   const std::vector<ArgumentParserPtr>& subParsers()const{ return subParsers_;}
 private:
-  template <typename Iter>
-  void parse(Iter first,Iter last);
+  friend ParseResult<CharT>;
+
+  struct PrivateTag{ explicit PrivateTag()=default; };
+
+public:
+  // for std::allocate_shared, PrivateTag restricts it to the parser itself
+  ArgumentParser(PrivateTag,
+                 std::shared_ptr<detail::ParserTree<CharT>> tree,
+                 const String& prefixChars)
+    :positionalSlots_(tree->resource),
+     optionalSlots_(tree->resource),
+     optionIndex_(tree->resource),
+     optionKeys_(tree->resource),
+     optionTrie_(tree->resource),
+     subParserIndex_(tree->resource),
+     slot_(tree->newSlot()),
+     tree_(std::move(tree)),
+     prefixChars_(prefixChars)
+  {}
+
+private:
+  template<typename Impl>
+  std::shared_ptr<Impl> makeArg()const;
+
+  // frees the slot of a removed arg, a handle still used
+  // keeps its settings in a tree of its own
+  void detachArg(ArgInfo<CharT>& arg, bool used)const;
+
+  // frees the slots of a removed sub parser, its args and sub parsers,
+  // a sub parser still used moves them to a tree of its own
+  void detachSubParser(ArgumentParser& parser, bool used)const;
+  void moveSlots(const std::shared_ptr<detail::ParserTree<CharT>>& tree);
+
+  // tryParseArgs() without clear of the stats
+  ParseStatus<CharT> parseViews(const StringViews& args,
+                                ParseResult<CharT>& result)const;
+
+  ParseStatus<CharT> parse(const StringView* tokens,std::size_t count,
+                           ParseResult<CharT>& result)const;
+
+  ParseStatus<CharT> parse(const StringView* tokens,
+                           const TokenKind* kinds,
+                           std::size_t first,std::size_t last,
+                           ParseResult<CharT>& result)const;
+
+  void classify(const StringView* tokens,std::size_t count,
+                std::vector<TokenKind>& kinds)const;
 
-  template <typename Iter>
-  Iter pasrePositional(Iter first,Iter last);
+  // positional values are [first,last) and [tailFirst,tailLast)
+  ParseStatus<CharT> pasrePositional(const StringView* tokens,
+                                     std::size_t first,std::size_t last,
+                                     std::size_t tailFirst,std::size_t tailLast,
+                                     ParseResult<CharT>& result)const;
 
-  template <typename Iter>
-  Iter parseOptional(Iter first,Iter last);
+  ParseStatus<CharT> parseOptional(const StringView* tokens,
+                                   const TokenKind* kinds,
+                                   std::size_t& first,std::size_t last,
+                                   ParseResult<CharT>& result)const;
 
-  std::shared_ptr<ArgInfo<CharT>>
-     findOptionalArg(std::basic_string_view<CharT> argOption);
+  static constexpr const std::size_t npos= std::size_t(-1);
+  static constexpr const std::size_t ambiguous=
+      detail::OptionTrie<CharT>::ambiguous;
 
-  String subParsersUsage()const;
+  // slot of the arg, npos, or ambiguous for an abbreviation of several args
+  std::size_t findOptionalArg(StringView optionString)const;
 
-  template <typename Iter>
-  void assignValues(std::shared_ptr<ArgInfo<CharT>> arg,Iter first,Iter last);
+  // two prefix chars and a name
+  bool isLongOption(StringView optionString)const;
+
+  // known option strings or sub parser names close to value
+  Strings suggest(StringView value, bool subParsers)const;
+
+  const ArgumentParser* findSubParser(StringView name)const;
+
+  template<typename OutputIt>
+  OutputIt writeSubParsersUsage(OutputIt out)const;
+
+  // values are tokens[position(first)] .. tokens[position(first+count-1)],
+  // the ArgInfo is used only for the conversion of the values
+  template <typename Position>
+  ParseStatus<CharT> assignValues(const detail::ArgRecord<CharT>& arg,
+                                  std::size_t slot,
+                                  const StringView* tokens,
+                                  std::size_t first,std::size_t count,
+                                  Position position,
+                                  ParseResult<CharT>& result)const;
+
+  ArgInfoPtr argInfoPtr(const ArgInfo<CharT>* arg)const;
 
 private:
   std::vector<ArgInfoPtr> positionals_;
   std::vector<ArgInfoPtr> optionals_;
   std::vector<ArgumentParserPtr> subParsers_;
 
+  // slots of positionals_ and optionals_, the parse reads
+  // ParserTree::args by them and dereferences an arg only for its values
+  std::pmr::vector<std::size_t> positionalSlots_;
+  std::pmr::vector<std::size_t> optionalSlots_;
+
+  // option string -> slot of the arg,
+  // keys refer to optionKeys_, copies of the optionStrings() of the args
+  // kept next to each other for the lookup
+  std::pmr::unordered_map<std::basic_string_view<CharT>,std::size_t> optionIndex_;
+  std::pmr::deque<std::basic_string<CharT>> optionKeys_;
+  // option strings -> slot, filled while allowAbbrev_ only
+  detail::OptionTrie<CharT> optionTrie_;
+  bool allowAbbrev_= false;
+
+  std::size_t suggestionCount_= 3;
+  std::size_t suggestionDistance_= 2;
+  mutable std::shared_ptr<const detail::SuggestionIndex<CharT>> suggestionIndex_;
+  // sub parser name -> index in subParsers_
+  std::pmr::unordered_map<std::basic_string_view<CharT>,std::size_t> subParserIndex_;
+
+  // sum of minCount() of all positionals_
+  std::size_t positionalsMinCount_= 0;
+
+  std::size_t slot_= 0;
+  std::shared_ptr<detail::ParserTree<CharT>> tree_;
+
   String name_;
   String help_;
-  bool exists_ = false;
   String prefixChars_;
+
+  // generated texts, valid while revision==tree_->revision
+  struct TextCache
+  {
+    std::size_t revision= std::size_t(-1);
+    String text;
+  };
+  mutable TextCache usageCache_;
+  // by 2*level+recursive, only the requested levels
+  mutable std::map<std::size_t,TextCache> helpCache_;
+
 };
 //------------------------------------------------------------------
 template<typename CharT>
-std::shared_ptr<ArgInfo<CharT>>
-ArgumentParser<CharT>::findOptionalArg(
-    std::basic_string_view<CharT> optionString)
-{
-  using namespace  std;
-  auto it= find_if(cbegin(optionals_),cend(optionals_),
-                   [&](auto arg)
-  {
-    const auto& strings = arg->optionStrings();
-    auto first = cbegin(strings);
-    auto last  = cend(strings);
-    return find(first,last,optionString)!=last;
-  });
-  return it==cend(optionals_) ? nullptr : *it;
+bool ParseResult<CharT>::exists(const ArgumentParser<CharT>& parser)const
+{
+  return slotExists(parser.slot_);
+}
+//------------------------------------------------------------------
+template<typename CharT>
+template<typename Impl>
+std::shared_ptr<Impl> ArgumentParser<CharT>::makeArg()const
+{
+  // object and control block in one allocation from the tree resource
+  auto arg= std::allocate_shared<Impl>(
+        std::pmr::polymorphic_allocator<char>(tree_->resource));
+  arg->slot_= tree_->newSlot();
+  arg->tree_= tree_;
+  tree_->args[arg->slot_].info= arg.get();
+  tree_->args[arg->slot_].convert= &Impl::convert;
+  tree_->modified();
+  return arg;
 }
 //------------------------------------------------------------------
 template<typename CharT>
-template <typename Iter>
-void ArgumentParser<CharT>::assignValues(
-    typename ArgumentParser<CharT>::ArgInfoPtr arg,
-    Iter first, Iter last)
+void ArgumentParser<CharT>::detachArg(ArgInfo<CharT>& arg, bool used)const
 {
-  const std::size_t count = std::distance(first,last);
-  if(count < arg->minCount() || count > arg->maxCount())
-  {   
-    throw WrongCountException<CharT>(arg);
+  tree_->result.reset(arg.slot_);
+  if(used)
+  {
+    auto tree= std::allocate_shared<detail::ParserTree<CharT>>(
+          std::pmr::polymorphic_allocator<char>(tree_->resource),
+          tree_->resource);
+    const std::size_t slot= tree->newSlot();
+    tree->args[slot]= tree_->args[arg.slot_];
+    tree_->freeSlot(arg.slot_);
+    arg.slot_= slot;
+    arg.tree_= std::move(tree);
   }
+  else
+    tree_->freeSlot(arg.slot_);
+}
+//------------------------------------------------------------------
+template<typename CharT>
+void ArgumentParser<CharT>::detachSubParser(ArgumentParser& parser,
+                                            bool used)const
+{
+  std::shared_ptr<detail::ParserTree<CharT>> tree;
+  if(used)
+  {
+    tree= std::allocate_shared<detail::ParserTree<CharT>>(
+          std::pmr::polymorphic_allocator<char>(tree_->resource),
+          tree_->resource);
+    // the cached texts of the parser are outdated
+    tree->revision= tree_->revision+1;
+    tree->lazy= tree_->lazy;
+  }
+  parser.moveSlots(tree);
+}
+//------------------------------------------------------------------
+// slots of the parser, its args and sub parsers are moved to tree,
+// freed if tree is nullptr
+template<typename CharT>
+void ArgumentParser<CharT>::moveSlots(
+    const std::shared_ptr<detail::ParserTree<CharT>>& tree)
+{
+  detail::ParserTree<CharT>& from= *tree_;
+  const auto moveSlot= [&](std::size_t slot)
+  {
+    from.result.reset(slot);
+    std::size_t newSlot= slot;
+    if(tree)
+    {
+      newSlot= tree->newSlot();
+      tree->args[newSlot]= from.args[slot];
+    }
+    from.freeSlot(slot);
+    return newSlot;
+  };
 
-  if(count==0)
-    return;
+  // the parser takes the first slot, it is the root of tree
+  slot_= moveSlot(slot_);
 
-  try
+  const auto moveArgs= [&](const std::vector<ArgInfoPtr>& args,
+                           std::pmr::vector<std::size_t>& slots)
   {
-     if(arg->typeGroup()==TypeGroup::number ||
-        arg->typeGroup()==TypeGroup::string)
-     {
-        arg->assingOrAppendFromString(*first);
-     }
-     else
-     {
-       for(;first!=last; ++first)
-         arg->assingOrAppendFromString(*first);
-     }
-  }
-  catch (const std::out_of_range&)
+    for(std::size_t i=0; i<args.size(); ++i)
+    {
+      ArgInfo<CharT>& arg= *args[i];
+      if(!tree)
+      {
+        detachArg(arg,args[i].use_count()>1);
+        continue;
+      }
+      arg.slot_= slots[i]= moveSlot(arg.slot_);
+      arg.tree_= tree;
+    }
+  };
+  moveArgs(optionals_,optionalSlots_);
+  moveArgs(positionals_,positionalSlots_);
+
+  if(tree)
   {
-    throw OutOfRangeException<CharT>(*first,arg);
+    // the lookup tables give slots
+    for(const auto& argPtr: optionals_)
+      for(const auto& optionString: argPtr->optionStrings())
+        optionIndex_.find(optionString)->second= argPtr->slot_;
+    setAllowAbbrev(allowAbbrev_);
   }
-  catch (const std::range_error&)
+
+  for(const auto& parserPtr: subParsers_)
+    parserPtr->moveSlots(tree);
+
+  if(tree)
+    tree_= tree;
+}
+//------------------------------------------------------------------
+template<typename CharT>
+std::size_t
+ArgumentParser<CharT>::findOptionalArg(StringView optionString)const
+{
+  auto it= optionIndex_.find(optionString);
+  if(it!=optionIndex_.cend())
+    return it->second;
+
+  if(allowAbbrev_ && isLongOption(optionString))
+    return optionTrie_.findPrefix(optionString);
+  return npos;
+}
+//------------------------------------------------------------------
+template<typename CharT>
+typename ArgumentParser<CharT>::Strings
+ArgumentParser<CharT>::suggest(StringView value, bool subParsers)const
+{
+  if(suggestionCount_==0)
+    return Strings();
+
+  // error path only, one build per change of the schema,
+  // concurrent parses share it
+  std::shared_ptr<const detail::SuggestionIndex<CharT>> index;
   {
-    throw OutOfRangeException<CharT>(*first,arg);
+    std::lock_guard<std::mutex> lock(tree_->suggestionMutex);
+    if(!suggestionIndex_ || suggestionIndex_->revision!=tree_->revision)
+    {
+      auto newIndex= std::make_shared<detail::SuggestionIndex<CharT>>();
+      newIndex->revision= tree_->revision;
+      for(const auto& key: optionKeys_)
+        newIndex->options.insert(key);
+      for(const auto& parser: subParsers_)
+        newIndex->subParsers.insert(parser->name_);
+      suggestionIndex_= std::move(newIndex);
+    }
+    index= suggestionIndex_;
   }
-  catch (const std::length_error&)
+
+  const auto matches=
+      (subParsers ? index->subParsers : index->options)
+        .find(value,std::min(suggestionDistance_,value.size()/3),
+              suggestionCount_);
+
+  Strings suggestions;
+  suggestions.reserve(matches.size());
+  for(const auto& match: matches)
+    suggestions.emplace_back(match.word);
+  return suggestions;
+}
+//------------------------------------------------------------------
+template<typename CharT>
+bool ArgumentParser<CharT>::isLongOption(StringView optionString)const
+{
+  return optionString.size()>2 &&
+         prefixChars_.find(optionString[0])!=String::npos &&
+         prefixChars_.find(optionString[1])!=String::npos;
+}
+//------------------------------------------------------------------
+template<typename CharT>
+const ArgumentParser<CharT>*
+ArgumentParser<CharT>::findSubParser(StringView name)const
+{
+  auto it= subParserIndex_.find(name);
+  return it==subParserIndex_.cend() ? nullptr : subParsers_[it->second].get();
+}
+//------------------------------------------------------------------
+template<typename CharT>
+template <typename Position>
+ParseStatus<CharT> ArgumentParser<CharT>::assignValues(
+    const detail::ArgRecord<CharT>& arg,
+    std::size_t slot,
+    const StringView* tokens,
+    std::size_t first, std::size_t count,
+    Position position,
+    ParseResult<CharT>& result)const
+{
+  if(count < arg.minCount || count > arg.maxCount)
+    return {ErrorCode::wrongCount, position(first), count, arg.info, this};
+
+  detail::PhaseTimer timer(result.stats_,ParsePhase::conversion);
+  result.stats_.count(ParsePhase::conversion,count);
+
+  if(tree_->lazy)
   {
-    throw LengthErrorException<CharT>(*first,arg);
+    // a single value replaces the previous one
+    if(arg.maxCount<=1)
+      result.clearRaw(slot);
+
+    for(std::size_t i=first; i<first+count; ++i)
+      result.appendRaw(slot,tokens[position(i)]);
+    return {};
   }
-  catch (const std::invalid_argument&)
+
+  for(std::size_t i=first; i<first+count; ++i)
   {
-   throw InvalidArgumentException<CharT>(*first,arg);
+    const std::size_t index= position(i);
+    const ErrorCode error= arg.convert(*arg.info,tokens[index],result);
+    if(error!=ErrorCode::none)
+      return {error, index, 1, arg.info, this};
   }
+  return {};
 }
 //------------------------------------------------------------------
 template<typename CharT>
-template<typename Iter>
-Iter ArgumentParser<CharT>::pasrePositional(Iter first, Iter last)
+ParseStatus<CharT> ArgumentParser<CharT>::pasrePositional(
+    const StringView* tokens,
+    std::size_t first, std::size_t last,
+    std::size_t tailFirst, std::size_t tailLast,
+    ParseResult<CharT>& result)const
 {
   using namespace std;
 
-  size_t totalCount= distance(first,last);
+  detail::PhaseTimer timer(result.stats_,ParsePhase::positional);
+
+  // k-th positional value -> token index
+  const size_t headCount= last-first;
+  const auto position= [=](size_t k)
+  {
+    return k<headCount ? first+k : tailFirst+(k-headCount);
+  };
+
+  size_t totalCount= headCount+(tailLast-tailFirst);
+  result.stats_.count(ParsePhase::positional,totalCount);
+  size_t shouldRemain= positionalsMinCount_;
+  size_t k= 0;
 
-  for(auto argIt=begin(positionals_); argIt!=end(positionals_); ++argIt)
+  const detail::ParserTree<CharT>& tree= *tree_;
+  for(size_t i=0; i<positionalSlots_.size(); ++i)
   {
-    (*argIt)->exists_= true;
+    const size_t slot= positionalSlots_[i];
+    const detail::ArgRecord<CharT>& arg= tree.args[slot];
+    result.slot(slot).exists= true;
+    result.stats_.count(ParsePhase::positional);
 
-    const size_t shouldRemain=
-        accumulate(next(argIt), end(positionals_), 0u,
-           [](size_t sum,auto arg){ return sum + arg->minCount_; });
+    // sum of minCount of the next positionals
+    shouldRemain -= arg.minCount;
 
     const size_t available= (shouldRemain > totalCount)
         ? totalCount
         : totalCount-shouldRemain;
 
-    const size_t count= std::min((*argIt)->maxCount(),available);
-    auto lastValue= next(first,count);
+    const size_t count= std::min(arg.maxCount,available);
 
-    assignValues((*argIt),first,lastValue);
-    first= lastValue;
+    const auto status= assignValues(arg,slot,tokens,k,count,position,result);
+    if(!status.ok())
+      return status;
+
+    k+= count;
     totalCount -= count;
   }
 
-  if(first!=last)
-    throw UnrecognizedArgumentsException<CharT>(Strings(first,last));
-
-  return first;
+  if(totalCount!=0)
+  {
+    const size_t index= position(k);
+    return {ErrorCode::unrecognizedArguments,
+            index, (tailFirst==tailLast ? last : tailLast)-index,
+            nullptr, this};
+  }
+  return {};
 }
 //------------------------------------------------------------------
 template<typename CharT>
-template<typename Iter>
-Iter ArgumentParser<CharT>::parseOptional(Iter first, Iter last)
+ParseStatus<CharT> ArgumentParser<CharT>::parseOptional(
+    const StringView* tokens,
+    const TokenKind* kinds,
+    std::size_t& first, std::size_t last,
+    ParseResult<CharT>& result)const
 {
   using namespace std;
-  using namespace std::placeholders;
-  using StringUtils::hasPrefix;
 
+  const detail::ParserTree<CharT>& tree= *tree_;
+  const auto position= [](size_t k){ return k; };
   while(first!=last)
   {
-    auto arg = findOptionalArg(*first);
-    if(!arg)
+    size_t slot= npos;
+    if(kinds[first]==TokenKind::option)
     {
-      /* throw UnrecognizedArgumentsException<CharT>(Strings(first,last)); */
-      return first;
+      detail::PhaseTimer timer(result.stats_,ParsePhase::optionalLookup);
+      result.stats_.count(ParsePhase::optionalLookup);
+      slot= findOptionalArg(tokens[first]);
     }
+    if(slot==npos)
+      return {};
+    if(slot==ambiguous)
+      return {ErrorCode::ambiguousOption, first, 1, nullptr, this};
 
-    arg->exists_= true;
-    first= next(first);
+    const detail::ArgRecord<CharT>& arg= tree.args[slot];
+    result.slot(slot).exists= true;
+    const size_t optionIndex= first++;
 
-    Iter nextOption=
-       find_if(first, last, bind(hasPrefix<String>, _1, prefixChars_));
+    const TokenKind* nextOption=
+       find_if(kinds+first, kinds+last,
+               [](TokenKind kind){ return kind!=TokenKind::value; });
 
-    const size_t count= distance(first,nextOption);
-    const size_t currentArgCount= std::min(count,arg->maxCount());
-    Iter lastValue= next(first,currentArgCount);
+    const size_t count= distance(kinds+first,nextOption);
+    const size_t currentArgCount= std::min(count,arg.maxCount);
 
-    assignValues(arg,first,lastValue);
-    first= lastValue;
+    auto status= assignValues(arg,slot,tokens,first,currentArgCount,position,result);
+    if(!status.ok())
+    {
+      if(status.error==ErrorCode::wrongCount)
+        status.index= optionIndex;
+      return status;
+    }
+    first+= currentArgCount;
   }
 
-  for(auto arg:optionals_)
+  detail::PhaseTimer timer(result.stats_,ParsePhase::requiredCheck);
+  result.stats_.count(ParsePhase::requiredCheck,optionals_.size());
+  for(const size_t slot: optionalSlots_)
   {
-    if(arg->required_ && !arg->exists_)
-       throw ArgumentRequiredException<CharT>(arg);
+    if(tree.args[slot].required && !result.slotExists(slot))
+      return {ErrorCode::argumentRequired, ParseStatus<CharT>::npos, 0,
+              tree.args[slot].info, this};
   }
-  return first;
+  return {};
 }
 //------------------------------------------------------------------
 template<typename CharT>
-template<typename Iter>
-void ArgumentParser<CharT>::parse(Iter first, Iter last)
+void ArgumentParser<CharT>::classify(const StringView* tokens,
+                                     std::size_t count,
+                                     std::vector<TokenKind>& kinds)const
 {
   using namespace std;
-  using namespace std::placeholders;
-  using StringUtils::hasPrefix;
 
-  // find sub parser
-  auto subParserIt= end(subParsers_);
-  auto endOfMainParser= find_if(first,last,
-      [&](const auto& s)
-      {
-        subParserIt= find_if(begin(subParsers_), end(subParsers_),
-            [&s](auto parser)
-            {
-              return parser->name_== s;
-            });
-        return subParserIt != end(subParsers_);
-      });
+  // single pass over the whole command line,
+  // sub parser names switch the parser used for the following tokens
+  const ArgumentParser* parser= this;
+  bool afterSeparator= false;
+  for(const StringView* last= tokens+count; tokens!=last; ++tokens)
+  {
+    const StringView s(*tokens);
+    const StringView prefixChars(parser->prefixChars_);
+    const bool prefixed= s.size()>=2 && prefixChars.find(s[0])!=StringView::npos;
 
-  // find end positional-s args
-  auto endOfPositional=
-    find_if(first, endOfMainParser, bind(hasPrefix<String>, _1, prefixChars_));
+    if(afterSeparator)
+    {
+      kinds.push_back(TokenKind::value);
+    }
+    else if(prefixed && s.size()==2 && s[1]==s[0]) // "--"
+    {
+      kinds.push_back(TokenKind::separator);
+      afterSeparator= true;
+    }
+    else if(auto subParser= parser->findSubParser(s))
+    {
+      kinds.push_back(TokenKind::subParser);
+      parser= subParser;
+    }
+    else if(prefixed && !isdigit(s[1]))
+    {
+      kinds.push_back(TokenKind::option);
+    }
+    else
+    {
+      kinds.push_back(TokenKind::value);
+    }
+  }
+}
+//------------------------------------------------------------------
+template<typename CharT>
+ParseStatus<CharT> ArgumentParser<CharT>::parse(const StringView* tokens,
+                                                std::size_t count,
+                                                ParseResult<CharT>& result)const
+{
+  detail::PhaseTimer timer(result.stats_,ParsePhase::other);
+  result.stats_.count(ParsePhase::other);
 
-  pasrePositional(first, endOfPositional);
-  auto it= parseOptional(endOfPositional, endOfMainParser);
+  std::vector<TokenKind>& kinds= result.kinds_;
+  {
+    detail::PhaseTimer classifyTimer(result.stats_,ParsePhase::classify);
+    result.stats_.count(ParsePhase::classify,count);
+    kinds.clear();
+    kinds.reserve(count);
+    classify(tokens,count,kinds);
+  }
+  result.reserve(tree_->slotCount);
+  return parse(tokens,kinds.data(),0,count,result);
+}
+//------------------------------------------------------------------
+template<typename CharT>
+ParseStatus<CharT> ArgumentParser<CharT>::parse(const StringView* tokens,
+                                                const TokenKind* kinds,
+                                                std::size_t first,
+                                                std::size_t last,
+                                                ParseResult<CharT>& result)const
+{
+  using namespace std;
+
+  // [first, endOfPositional) positional values
+  // [endOfPositional, separator) optional args
+  // (separator, endOfMainParser) positional values after "--"
+  // (endOfMainParser, last) sub parser args
+  const size_t endOfMainParser=
+      find(kinds+first,kinds+last,TokenKind::subParser)-kinds;
+  const size_t separator=
+      find(kinds+first,kinds+endOfMainParser,TokenKind::separator)-kinds;
+  const size_t endOfPositional=
+      find_if(kinds+first,kinds+separator,
+              [](TokenKind kind){ return kind!=TokenKind::value; })-kinds;
+
+  const size_t tailFirst=
+      separator==endOfMainParser ? endOfMainParser : separator+1;
+
+  auto status= pasrePositional(tokens,first,endOfPositional,
+                               tailFirst,endOfMainParser,result);
+  if(!status.ok())
+    return status;
+
+  size_t it= endOfPositional;
+  status= parseOptional(tokens,kinds,it,separator,result);
+  if(!status.ok())
+    return status;
 
   // Problems
-  if(it!=endOfMainParser)
+  if(it!=separator)
   {
     if(subParsers_.empty())
+      return {ErrorCode::unrecognizedArguments, it, separator-it, nullptr, this};
+    else
+      return {ErrorCode::invalidChoice, it, 1, nullptr, this};
+  }
+
+  // sub parser
+  if(endOfMainParser!=last)
+  {
+    const ArgumentParser* subParser= nullptr;
     {
-      throw UnrecognizedArgumentsException<CharT>(Strings(it,endOfMainParser));
+      detail::PhaseTimer timer(result.stats_,ParsePhase::subParser);
+      result.stats_.count(ParsePhase::subParser);
+      subParser= findSubParser(tokens[endOfMainParser]);
     }
-    else
+    assert(subParser != nullptr);
+
+    result.slot(subParser->slot_).exists= true;
+    return subParser->parse(tokens,kinds,endOfMainParser+1,last,result);
+  }
+  return {};
+}
+//------------------------------------------------------------------
+template<typename CharT>
+typename ArgumentParser<CharT>::ArgInfoPtr
+ArgumentParser<CharT>::argInfoPtr(const ArgInfo<CharT>* arg)const
+{
+  return std::const_pointer_cast<ArgInfo<CharT>>(arg->shared_from_this());
+}
+//------------------------------------------------------------------
+template<typename CharT>
+void ArgumentParser<CharT>::throwError(const ParseStatus<CharT>& status,
+                                       const StringView* tokens)const
+{
+  using namespace std;
+
+  // an unknown option is close to option strings,
+  // other values to sub parser names
+  const auto suggestFor= [this](StringView value)
+  {
+    const bool option= value.size()>=2 &&
+                       prefixChars_.find(value[0])!=String::npos &&
+                       !isdigit(value[1]);
+    return suggest(value,!option);
+  };
+
+  switch(status.error)
+  {
+    case ErrorCode::none:
+      return;
+
+    case ErrorCode::wrongCount:
+      throw WrongCountException<CharT>(argInfoPtr(status.arg));
+
+    case ErrorCode::invalidChoice:
     {
       Strings subParsersNames;
       subParsersNames.reserve(subParsers_.size());
@@ -1042,65 +2112,235 @@ void ArgumentParser<CharT>::parse(Iter first, Iter last)
                 back_inserter(subParsersNames),
                 [](auto parser){ return parser->name_; });
 
-      throw InvalidChoiceException<CharT>(*it,subParsersNames);
+      throw InvalidChoiceException<CharT>(String(tokens[status.index]),
+                                          subParsersNames,
+                                          suggestFor(tokens[status.index]));
+    }
+
+    case ErrorCode::unrecognizedArguments:
+      throw UnrecognizedArgumentsException<CharT>(
+            Strings(tokens+status.index,tokens+status.index+status.count),
+            suggestFor(tokens[status.index]));
+
+    case ErrorCode::argumentRequired:
+      throw ArgumentRequiredException<CharT>(argInfoPtr(status.arg));
+
+    case ErrorCode::outOfRange:
+      throw OutOfRangeException<CharT>(String(tokens[status.index]),
+                                       argInfoPtr(status.arg));
+
+    case ErrorCode::invalidArgument:
+      throw InvalidArgumentException<CharT>(String(tokens[status.index]),
+                                            argInfoPtr(status.arg));
+
+    case ErrorCode::lengthError:
+      throw LengthErrorException<CharT>(String(tokens[status.index]),
+                                        argInfoPtr(status.arg));
+
+    case ErrorCode::ambiguousOption:
+    {
+      const StringView value= tokens[status.index];
+      StringViews candidates;
+      optionTrie_.keysWithPrefix(value,std::back_inserter(candidates));
+      throw AmbiguousOptionException<CharT>(
+            String(value),Strings(cbegin(candidates),cend(candidates)));
     }
   }
+}
+//------------------------------------------------------------------
+template <typename CharT>
+ParseStatus<CharT> ArgumentParser<CharT>::tryParseArgs(int argc, CharT *argv[])
+{
+  return tryParseArgs(StringViews(argv,argv+argc));
+}
+//------------------------------------------------------------------
+template<typename CharT>
+ParseStatus<CharT> ArgumentParser<CharT>::tryParseArgs(int argc,
+                                                       const CharT *argv[])
+{
+  return tryParseArgs(StringViews(argv,argv+argc));
+}
+//------------------------------------------------------------------
+template<typename CharT>
+ParseStatus<CharT>
+ArgumentParser<CharT>::tryParseArgs(const ArgumentParser::Strings &args)
+{
+  return tryParseArgs(StringViews(std::cbegin(args),std::cend(args)));
+}
+//------------------------------------------------------------------
+template<typename CharT>
+ParseStatus<CharT>
+ArgumentParser<CharT>::tryParseArgs(const ArgumentParser::StringViews &args)
+{
+  return tryParseArgs(args,tree_->result);
+}
+//------------------------------------------------------------------
+template<typename CharT>
+ParseStatus<CharT>
+ArgumentParser<CharT>::tryParseArgs(const ArgumentParser::StringViews &args,
+                                    ParseResult<CharT>& result)const
+{
+  result.stats_.clear();
+  return parseViews(args,result);
+}
+//------------------------------------------------------------------
+template<typename CharT>
+ParseStatus<CharT>
+ArgumentParser<CharT>::parseViews(const ArgumentParser::StringViews &args,
+                                  ParseResult<CharT>& result)const
+{
+  if(!tree_->lazy)
+    return parse(args.data(),args.size(),result);
 
-  // sub parser
-  if(endOfMainParser!=last)
+  // raw tokens are read after the parse, args may be gone
+  const StringViews& tokens= result.keepTokens(args.data(),args.size());
+  return parse(tokens.data(),tokens.size(),result);
+}
+//------------------------------------------------------------------
+template<typename CharT>
+ParseStatus<CharT>
+ArgumentParser<CharT>::tryParseCmdLine(const ArgumentParser::String &str)
+{
+  SplitBuffer buffer;
+  return tryParseCmdLine(str,buffer);
+}
+//------------------------------------------------------------------
+template<typename CharT>
+ParseStatus<CharT>
+ArgumentParser<CharT>::tryParseCmdLine(StringView str, SplitBuffer& buffer)
+{
+  return tryParseCmdLine(str,buffer,tree_->result);
+}
+//------------------------------------------------------------------
+template<typename CharT>
+ParseStatus<CharT>
+ArgumentParser<CharT>::tryParseCmdLine(StringView str,
+                                       SplitBuffer& buffer,
+                                       ParseResult<CharT>& result)const
+{
+  result.stats_.clear();
+  const StringViews* tokens= nullptr;
   {
-    assert(subParserIt != end(subParsers_));
-
-    (*subParserIt)->exists_= true;
-    (*subParserIt)->parse(next(endOfMainParser),last);
+    detail::PhaseTimer timer(result.stats_,ParsePhase::tokenize);
+    tokens= &buffer.split(str);
+    result.stats_.count(ParsePhase::tokenize,tokens->size());
   }
+  return parseViews(*tokens,result);
 }
 //------------------------------------------------------------------
 template <typename CharT>
 void ArgumentParser<CharT>::parseArgs(int argc, CharT *argv[])
 {
-  parse(argv,argv+argc);
+  parseArgs(StringViews(argv,argv+argc));
 }
 //------------------------------------------------------------------
 template<typename CharT>
 void ArgumentParser<CharT>::parseArgs(int argc, const CharT *argv[])
 {
-  parse(argv,argv+argc);
+  parseArgs(StringViews(argv,argv+argc));
 }
 //------------------------------------------------------------------
 template<typename CharT>
 void ArgumentParser<CharT>::parseArgs(const ArgumentParser::Strings &args)
 {
-  parse(std::begin(args),std::end(args));
+  parseArgs(StringViews(std::cbegin(args),std::cend(args)));
+}
+//------------------------------------------------------------------
+template<typename CharT>
+void ArgumentParser<CharT>::parseArgs(const ArgumentParser::StringViews &args)
+{
+  parseArgs(args,tree_->result);
+}
+//------------------------------------------------------------------
+template<typename CharT>
+void ArgumentParser<CharT>::parseArgs(const ArgumentParser::StringViews &args,
+                                      ParseResult<CharT>& result)const
+{
+  const auto status= tryParseArgs(args,result);
+  if(!status.ok())
+    status.parser->throwError(status,args.data());
 }
 //------------------------------------------------------------------
 template<typename CharT>
 void ArgumentParser<CharT>::parseCmdLine(const ArgumentParser::String &str)
 {
-  parseArgs(StringUtils::split<CharT,Strings>(str));
+  SplitBuffer buffer;
+  parseCmdLine(str,buffer);
+}
+//------------------------------------------------------------------
+template<typename CharT>
+void ArgumentParser<CharT>::parseCmdLine(StringView str, SplitBuffer& buffer)
+{
+  parseCmdLine(str,buffer,tree_->result);
+}
+//------------------------------------------------------------------
+template<typename CharT>
+void ArgumentParser<CharT>::parseCmdLine(StringView str,
+                                         SplitBuffer& buffer,
+                                         ParseResult<CharT>& result)const
+{
+  parseArgs(buffer.split(str),result);
 }
 //------------------------------------------------------------------
 template <typename CharT>
 typename ArgumentParser<CharT>::ArgumentParserPtr
 ArgumentParser<CharT>::addSubParser(const ArgumentParser::String &name)
 {
-  ArgumentParserPtr parser(new ArgumentParser);
+  ArgumentParserPtr parser=
+     std::allocate_shared<ArgumentParser>(
+       std::pmr::polymorphic_allocator<char>(tree_->resource),
+       PrivateTag(),tree_,StringUtils::LatinView("-/"));
   parser->name_= name;
+
+  [[maybe_unused]] const bool inserted=
+    subParserIndex_.emplace(parser->name_,subParsers_.size()).second;
+  assert(inserted && "Sub parser already exists!");
+
   subParsers_.push_back(parser);
+  tree_->modified();
   return parser;
 }
 //----------------------------------------------------------------------------
 template<typename CharT>
 void ArgumentParser<CharT>::removeAllArguments()
 {
+  for(const auto& argPtr: optionals_)
+    detachArg(*argPtr,argPtr.use_count()>1);
+  for(const auto& argPtr: positionals_)
+    detachArg(*argPtr,argPtr.use_count()>1);
+
+  optionIndex_.clear();
+  optionKeys_.clear();
+  optionTrie_.clear();
   optionals_.clear();
   positionals_.clear();
+  optionalSlots_.clear();
+  positionalSlots_.clear();
+  positionalsMinCount_= 0;
+  tree_->modified();
+}
+//----------------------------------------------------------------------------
+template<typename CharT>
+void ArgumentParser<CharT>::setAllowAbbrev(bool allow)
+{
+  allowAbbrev_= allow;
+  optionTrie_.clear();
+  if(allow)
+  {
+    for(const auto& key: optionKeys_)
+      optionTrie_.insert(key,optionIndex_.find(key)->second);
+  }
 }
 //----------------------------------------------------------------------------
 template<typename CharT>
 void ArgumentParser<CharT>::removeSubParsers()
 {
+  for(const auto& parserPtr: subParsers_)
+    detachSubParser(*parserPtr,parserPtr.use_count()>1);
+
+  subParserIndex_.clear();
   subParsers_.clear();
+  tree_->modified();
 }
 //----------------------------------------------------------------------------
 template<typename CharT>
@@ -1123,16 +2363,17 @@ ArgumentParser<CharT>::
   constexpr const TypeGroup group=
       TypeUtils::groupOfMaxCount<T,maxCount,CharT>();
 
-  std::shared_ptr<ArgImpl<T,group,CharT>>
-      argImplPtr(new ArgImpl<T,group,CharT>());
-  argImplPtr->minCount_= minCount;
-  argImplPtr->maxCount_= maxCount;
+  auto argImplPtr= makeArg<ArgImpl<T,group,CharT>>();
+  tree_->args[argImplPtr->slot_].minCount= minCount;
+  tree_->args[argImplPtr->slot_].maxCount= maxCount;
   argImplPtr->argType_= ArgType::positional;
   argImplPtr->name_ = name;
 
   positionals_.push_back(argImplPtr);
+  positionalSlots_.push_back(argImplPtr->slot_);
+  positionalsMinCount_+= minCount;
 
-  return Arg<T,group,CharT>(argImplPtr);
+  return Arg<T,group,CharT>(std::move(argImplPtr));
 }
 //----------------------------------------------------------------------------
 template<typename CharT>
@@ -1157,15 +2398,12 @@ ArgumentParser<CharT>::
   static_assert(sizeof...(optionStrings)>0,
                 "arg must have option strings!");
 
-//  assert(("Arg already exists!",findOptionalArg());
-
   constexpr const TypeGroup group=
       TypeUtils::groupOfMaxCount<T,maxCount,CharT>();
 
-  std::shared_ptr<ArgImpl<T,group,CharT>>
-      argImplPtr(new ArgImpl<T,group,CharT>());
-  argImplPtr->minCount_= minCount;
-  argImplPtr->maxCount_= maxCount;
+  auto argImplPtr= makeArg<ArgImpl<T,group,CharT>>();
+  tree_->args[argImplPtr->slot_].minCount= minCount;
+  tree_->args[argImplPtr->slot_].maxCount= maxCount;
   argImplPtr->argType_=  ArgType::optional;
   (argImplPtr->optionStrings_.push_back(std::forward<OptionStrings>(optionStrings)), ...);
 
@@ -1173,8 +2411,19 @@ ArgumentParser<CharT>::
 
   assert(("Invalid argument!",!argImplPtr->name().empty()));
 
+  for(const auto& optionString: argImplPtr->optionStrings())
+  {
+    optionKeys_.push_back(optionString);
+    [[maybe_unused]] const bool inserted=
+      optionIndex_.emplace(optionKeys_.back(),argImplPtr->slot_).second;
+    assert(inserted && "Arg already exists!");
+    if(allowAbbrev_)
+      optionTrie_.insert(optionKeys_.back(),argImplPtr->slot_);
+  }
+
   optionals_.push_back(argImplPtr);
-  return Arg<T,group,CharT>(argImplPtr);
+  optionalSlots_.push_back(argImplPtr->slot_);
+  return Arg<T,group,CharT>(std::move(argImplPtr));
 }
 //----------------------------------------------------------------------------
 template<typename CharT>
@@ -1256,109 +2505,173 @@ ArgumentParser<CharT>::
 }
 //------------------------------------------------------------------
 template<typename CharT>
-typename ArgumentParser<CharT>::String
-ArgumentParser<CharT>::subParsersUsage() const
+template<typename OutputIt>
+OutputIt ArgumentParser<CharT>::writeSubParsersUsage(OutputIt out) const
 {
   using namespace StringUtils::literals;
-  using StringUtils::joinF;
+  using StringUtils::writeString;
 
-  return  "{"_lv+
-          joinF<String>(subParsers_,", ",'\'','\'',[](const auto& p){return p->name_;})
-          +"}"_lv;
+  out= writeString(out,"{"_lv);
+  bool first= true;
+  for(const auto& parser: subParsers_)
+  {
+    if(parser->name_.empty())
+      continue;
+    if(!first)
+      out= writeString(out,", "_lv);
+    first= false;
+
+    *out++= CharT('\'');
+    out= writeString(out,parser->name_);
+    *out++= CharT('\'');
+  }
+  return writeString(out,"}"_lv);
 }
 //---------------------------------------------------------------------------------------
 template<typename CharT>
-typename ArgumentParser<CharT>::String
+const typename ArgumentParser<CharT>::String&
 ArgumentParser<CharT>::help(bool recursive, std::size_t level) const
+{
+  std::lock_guard<std::mutex> lock(tree_->textMutex);
+  TextCache& cache= helpCache_[2*level+(recursive ? 1 : 0)];
+  if(cache.revision!=tree_->revision)
+  {
+    cache.text.clear();
+    writeHelp(std::back_inserter(cache.text),recursive,level);
+    cache.revision= tree_->revision;
+  }
+  return cache.text;
+}
+//---------------------------------------------------------------------------------------
+template<typename CharT>
+template<typename OutputIt, detail::EnableIfNotStream<OutputIt>>
+OutputIt ArgumentParser<CharT>::writeHelp(OutputIt out,
+                                          bool recursive,
+                                          std::size_t level) const
 {
   using namespace std;
   using namespace StringUtils::literals;
+  using StringUtils::writeString;
+  using detail::writeHelpLine;
 
-  using StringUtils::join;
-  using detail::makeHelpLine;
-
-  auto indent= [](size_t level){ return String(4*level,CharT(' ')); };
+  auto indent= [&out](size_t level){ out= fill_n(out,4*level,CharT(' ')); };
 
-  String helpStr;
   if(!positionals_.empty() || !subParsers_.empty())
-    helpStr+= indent(level)+"positional arguments:\n"_lv;
+  {
+    indent(level);
+    out= writeString(out,"positional arguments:\n"_lv);
+  }
 
-  for(auto arg: positionals_)
-     helpStr+= indent(level+1)+makeHelpLine(arg)+"\n"_lv;
+  for(const auto& arg: positionals_)
+  {
+    indent(level+1);
+    out= writeString(writeHelpLine<CharT>(out,arg),"\n"_lv);
+  }
 
   if(!subParsers_.empty())
   {
-    helpStr+= indent(level+1)+subParsersUsage()+"\n"_lv;
-    for(auto parser: subParsers_)
+    indent(level+1);
+    out= writeString(writeSubParsersUsage(out),"\n"_lv);
+    for(const auto& parser: subParsers_)
     {
       if(!parser->help_.empty())
-        helpStr+=
-           indent(level+1)+ parser->name_ +" "_lv
-                          + parser->help_ +"\n"_lv;
+      {
+        indent(level+1);
+        out= writeString(out,parser->name_);
+        out= writeString(out," "_lv);
+        out= writeString(out,parser->help_);
+        out= writeString(out,"\n"_lv);
+      }
       if(recursive)
-        helpStr+= parser->help(recursive,level+2);
+        out= parser->writeHelp(out,recursive,level+2);
     }
   }
 
   if(!positionals_.empty() || !subParsers_.empty())
-    helpStr+= '\n';
+    *out++= CharT('\n');
 
   if(!optionals_.empty())
   {
-    helpStr += indent(level)+"optional arguments:\n"_lv;
-    for(auto arg: optionals_)
-      helpStr+= indent(level+1)+makeHelpLine(arg)+"\n"_lv;
+    indent(level);
+    out= writeString(out,"optional arguments:\n"_lv);
+    for(const auto& arg: optionals_)
+    {
+      indent(level+1);
+      out= writeString(writeHelpLine<CharT>(out,arg),"\n"_lv);
+    }
   }
-
-  return helpStr;
+  return out;
 }
 //----------------------------------------------------------------------------
 template<typename CharT>
-typename ArgumentParser<CharT>::String
-  ArgumentParser<CharT>::usage() const
+const typename ArgumentParser<CharT>::String&
+ArgumentParser<CharT>::usage() const
+{
+  std::lock_guard<std::mutex> lock(tree_->textMutex);
+  if(usageCache_.revision!=tree_->revision)
+  {
+    usageCache_.text.clear();
+    writeUsage(std::back_inserter(usageCache_.text));
+    usageCache_.revision= tree_->revision;
+  }
+  return usageCache_.text;
+}
+//----------------------------------------------------------------------------
+template<typename CharT>
+template<typename OutputIt, detail::EnableIfNotStream<OutputIt>>
+OutputIt ArgumentParser<CharT>::writeUsage(OutputIt out) const
 {
-  using namespace std;
-  using namespace std::placeholders;
   using namespace StringUtils::literals;
-  using StringUtils::appendJoinedF;
-  using detail::makeUsage;
+  using StringUtils::writeString;
 
-  String usageStr;
-
-  if(!optionals_.empty())
+  const auto writeArgs= [&out](const auto& args)
   {
-     appendJoinedF(usageStr,optionals_," ",
-                   [](const auto& a){ return makeUsage<CharT>(a);});
-  }
+    bool first= true;
+    for(const auto& arg: args)
+    {
+      if(!first)
+        out= writeString(out," "_lv);
+      first= false;
+      out= detail::writeUsage<CharT>(out,arg);
+    }
+  };
+
+  writeArgs(optionals_);
 
   if(!positionals_.empty())
   {
     if(!optionals_.empty())
-       usageStr+= " "_lv;
-
-     appendJoinedF(usageStr,positionals_," ",
-                   [](const auto& a){ return makeUsage<CharT>(a);});
+      out= writeString(out," "_lv);
+    writeArgs(positionals_);
   }
 
   if(subParsers_.empty())
-    return usageStr;
+    return out;
 
   if(!optionals_.empty() || !positionals_.empty())
-    usageStr+= " "_lv;
+    out= writeString(out," "_lv);
 
-  usageStr+= subParsersUsage();
-  return usageStr;
+  return writeSubParsersUsage(out);
 }
 //----------------------------------------------------------------------------
 template<typename CharT>
-void ArgumentParser<CharT>::reset()
-{
-  for(auto optPtr:optionals_)
-    optPtr->reset();
-  for(auto posPtr:positionals_)
-    posPtr->reset();
-  for(auto parserPtr:subParsers_)
-    parserPtr->reset();
+void ArgumentParser<CharT>::reset(ParseResult<CharT>& result)const
+{
+  // the root parser has the first slot of the tree,
+  // all slots of the result belong to it
+  if(slot_==0)
+  {
+    result.clear();
+    return;
+  }
+
+  result.reset(slot_);
+  for(const auto& optPtr:optionals_)
+    optPtr->reset(result);
+  for(const auto& posPtr:positionals_)
+    posPtr->reset(result);
+  for(const auto& parserPtr:subParsers_)
+    parserPtr->reset(result);
 }
 //----------------------------------------------------------------------------
 }
@@ -0,0 +1,259 @@
+#ifndef BATCHPARSER_H
+#define BATCHPARSER_H
+//----------------------------------------------------------------------------
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <thread>
+#include <vector>
+//----------------------------------------------------------------------------
+#include "ArgumentParser.h"
+//----------------------------------------------------------------------------
+namespace ArgParse
+{
+//----------------------------------------------------------------------------
+//                        BatchEntry<CharT>
+//----------------------------------------------------------------------------
+// Parse of one command line of a batch
+template <typename CharT>
+struct BatchEntry
+{
+  ParseResult<CharT> result;
+  ParseStatus<CharT> status;  // status.index refers to the tokens of the line
+  std::exception_ptr error;   // Exception<CharT> of a failed parse
+
+  bool ok()const{ return status.ok(); }
+};
+//----------------------------------------------------------------------------
+namespace detail
+{
+//----------------------------------------------------------------------------
+// Lines [first,last) of one worker packed in one atomic word.
+// The owner pops blocks from the front, thieves steal the back half.
+class WorkRange
+{
+public:
+  void assign(std::size_t first, std::size_t last)
+  {
+    range_.store(pack(first,last),std::memory_order_release);
+  }
+
+  bool pop(std::size_t grain, std::size_t& first, std::size_t& last)
+  {
+    std::uint64_t value= range_.load(std::memory_order_acquire);
+    for(;;)
+    {
+      const std::size_t f= front(value), l= back(value);
+      if(f>=l)
+        return false;
+
+      const std::size_t n= std::min(grain,l-f);
+      if(range_.compare_exchange_weak(value,pack(f+n,l),
+                                      std::memory_order_acq_rel))
+      {
+        first= f;
+        last= f+n;
+        return true;
+      }
+    }
+  }
+
+  bool steal(std::size_t& first, std::size_t& last)
+  {
+    std::uint64_t value= range_.load(std::memory_order_acquire);
+    for(;;)
+    {
+      const std::size_t f= front(value), l= back(value);
+      if(f>=l)
+        return false;
+
+      const std::size_t middle= f+(l-f)/2;
+      if(range_.compare_exchange_weak(value,pack(f,middle),
+                                      std::memory_order_acq_rel))
+      {
+        first= middle;
+        last= l;
+        return true;
+      }
+    }
+  }
+
+private:
+  static std::uint64_t pack(std::size_t first, std::size_t last)
+  {
+    return (std::uint64_t(first)<<32) | std::uint64_t(last);
+  }
+
+  static std::size_t front(std::uint64_t value){ return std::size_t(value>>32); }
+  static std::size_t back(std::uint64_t value){ return std::size_t(value & 0xFFFFFFFFu); }
+
+  std::atomic<std::uint64_t> range_{0};
+};
+//----------------------------------------------------------------------------
+} // end namespace detail
+//----------------------------------------------------------------------------
+//                        BatchParser<CharT>
+//----------------------------------------------------------------------------
+// Parses many command lines in parallel against one read-only schema.
+// Threads are started by parse() and joined before it returns, their
+// start up is paid once per batch. Split buffers are kept between calls.
+// The schema must not be modified while parse() runs.
+// parse() into Entries holds the results of all lines at once, forEach()
+// passes each line to a callback with one reused entry per thread.
+template <typename CharT=char>
+class BatchParser
+{
+public:
+  using StringView = std::basic_string_view<CharT>;
+  using StringViews= StringContainer<StringView>;
+  using Entries    = std::vector<BatchEntry<CharT>>;
+
+  explicit BatchParser(const ArgumentParser<CharT>& parser,
+                       std::size_t threadCount=
+                           std::thread::hardware_concurrency())
+    :parser_(parser),
+     workers_(std::max<std::size_t>(threadCount,1))
+  {}
+
+  BatchParser(const BatchParser&)= delete;
+  BatchParser& operator=(const BatchParser&)= delete;
+
+  std::size_t threadCount()const{ return workers_.size(); }
+
+  // entries[i] is the parse of lines[i], entries is resized to lines
+  void parse(const StringViews& lines, Entries& entries);
+
+  // f(i,entry) with the parse of lines[i], called by the parse threads
+  // concurrently, entry is valid during the call only; f must not throw
+  template <typename F>
+  void forEach(const StringViews& lines, F&& f);
+
+  template <typename Lines>
+  Entries parse(const Lines& lines)
+  {
+    Entries entries;
+    parse(StringViews(std::cbegin(lines),std::cend(lines)),entries);
+    return entries;
+  }
+
+private:
+  // lines popped by a worker at once, stealing takes half of the rest
+  static constexpr const std::size_t grain= 16;
+
+  struct alignas(64) Worker
+  {
+    detail::WorkRange range;
+    StringUtils::SplitBuffer<CharT> buffer;
+    BatchEntry<CharT> entry; // of forEach()
+  };
+
+  // visit(worker,i) for each line i of [0,count)
+  template <typename Visit>
+  void dispatch(std::size_t count, const Visit& visit);
+
+  template <typename Visit>
+  void run(std::size_t index, const Visit& visit);
+
+  void parseLine(Worker& worker, StringView line, BatchEntry<CharT>& entry);
+
+  const ArgumentParser<CharT>& parser_;
+  std::vector<Worker> workers_; // workers_[0] is the calling thread
+};
+//----------------------------------------------------------------------------
+template<typename CharT>
+void BatchParser<CharT>::parse(const StringViews& lines, Entries& entries)
+{
+  entries.clear();
+  entries.resize(lines.size());
+  dispatch(lines.size(),[&](Worker& worker, std::size_t i)
+  {
+    parseLine(worker,lines[i],entries[i]);
+  });
+}
+//----------------------------------------------------------------------------
+template<typename CharT>
+template<typename F>
+void BatchParser<CharT>::forEach(const StringViews& lines, F&& f)
+{
+  dispatch(lines.size(),[&](Worker& worker, std::size_t i)
+  {
+    BatchEntry<CharT>& entry= worker.entry;
+    entry.result.clear();
+    entry.error= nullptr;
+    parseLine(worker,lines[i],entry);
+    f(i,static_cast<const BatchEntry<CharT>&>(entry));
+  });
+}
+//----------------------------------------------------------------------------
+template<typename CharT>
+template<typename Visit>
+void BatchParser<CharT>::dispatch(std::size_t count, const Visit& visit)
+{
+  assert(count<=0xFFFFFFFFu && "Too many lines!");
+  if(count==0)
+    return;
+
+  // contiguous equal parts, stealing evens out the rest
+  const std::size_t n= workers_.size();
+  for(std::size_t i=0; i<n; ++i)
+    workers_[i].range.assign(count*i/n,count*(i+1)/n);
+
+  std::vector<std::thread> threads;
+  threads.reserve(n-1);
+  for(std::size_t i=1; i<n; ++i)
+    threads.emplace_back([this,i,&visit]{ run(i,visit); });
+
+  run(0,visit);
+
+  for(auto& thread: threads)
+    thread.join();
+}
+//----------------------------------------------------------------------------
+template<typename CharT>
+template<typename Visit>
+void BatchParser<CharT>::run(std::size_t index, const Visit& visit)
+{
+  Worker& worker= workers_[index];
+  const std::size_t n= workers_.size();
+
+  std::size_t first, last;
+  for(;;)
+  {
+    while(worker.range.pop(grain,first,last))
+    {
+      for(std::size_t line=first; line<last; ++line)
+        visit(worker,line);
+    }
+
+    // own range is empty, take half of the first non empty one
+    bool stolen= false;
+    for(std::size_t k=1; k<n && !stolen; ++k)
+      stolen= workers_[(index+k)%n].range.steal(first,last);
+
+    if(!stolen)
+      return;
+    worker.range.assign(first,last);
+  }
+}
+//----------------------------------------------------------------------------
+template<typename CharT>
+void BatchParser<CharT>::parseLine(Worker& worker, StringView line,
+                                   BatchEntry<CharT>& entry)
+{
+  entry.status= parser_.tryParseCmdLine(line,worker.buffer,entry.result);
+  if(entry.status.ok())
+    return;
+
+  try
+  {
+    entry.status.parser->throwError(entry.status,worker.buffer.tokens().data());
+  }
+  catch(...)
+  {
+    entry.error= std::current_exception();
+  }
+}
+//----------------------------------------------------------------------------
+}
+//----------------------------------------------------------------------------
+#endif // BATCHPARSER_H
@@ -0,0 +1,168 @@
+#ifndef BKTREE_H
+#define BKTREE_H
+//----------------------------------------------------------------------------
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+//----------------------------------------------------------------------------
+namespace ArgParse
+{
+//----------------------------------------------------------------------------
+namespace detail
+{
+//----------------------------------------------------------------------------
+// Levenshtein distance, row is a reusable buffer
+template<typename CharT>
+std::size_t editDistance(std::basic_string_view<CharT> a,
+                         std::basic_string_view<CharT> b,
+                         std::vector<std::size_t>& row)
+{
+  if(a.size()<b.size())
+    std::swap(a,b);
+
+  row.resize(b.size()+1);
+  for(std::size_t j=0; j<=b.size(); ++j)
+    row[j]= j;
+
+  for(std::size_t i=1; i<=a.size(); ++i)
+  {
+    std::size_t diagonal= row[0];
+    row[0]= i;
+    for(std::size_t j=1; j<=b.size(); ++j)
+    {
+      const std::size_t above= row[j];
+      row[j]= std::min({above+1, row[j-1]+1,
+                        diagonal+(a[i-1]==b[j-1] ? 0 : 1)});
+      diagonal= above;
+    }
+  }
+  return row[b.size()];
+}
+//----------------------------------------------------------------------------
+//                        BkTree<CharT>
+//----------------------------------------------------------------------------
+// Burkhard-Keller tree of words by edit distance. A query visits only
+// the children with the distance to their parent in [d-bound, d+bound],
+// where d is the distance of the query to the parent, so the words far
+// from the query are skipped. Words are views, they must outlive the tree.
+template<typename CharT>
+class BkTree
+{
+public:
+  using StringView= std::basic_string_view<CharT>;
+
+  struct Match
+  {
+    StringView word;
+    std::size_t distance;
+  };
+
+  void insert(StringView word);
+  void clear(){ nodes_.clear(); }
+  bool empty()const{ return nodes_.empty(); }
+
+  // up to count words within maxDistance, nearest first,
+  // equally near words in lexicographic order
+  std::vector<Match> find(StringView word,
+                          std::size_t maxDistance,
+                          std::size_t count)const;
+
+private:
+  static constexpr const std::uint32_t none= std::uint32_t(-1);
+
+  struct Node
+  {
+    StringView word;
+    std::size_t distance= 0;           // to the parent
+    std::uint32_t firstChild = none;
+    std::uint32_t nextSibling= none;
+  };
+
+  std::vector<Node> nodes_; // nodes_[0] is the root
+  std::vector<std::size_t> row_;
+};
+//----------------------------------------------------------------------------
+template<typename CharT>
+void BkTree<CharT>::insert(StringView word)
+{
+  if(nodes_.empty())
+  {
+    nodes_.push_back({word});
+    return;
+  }
+
+  std::uint32_t node= 0;
+  for(;;)
+  {
+    const std::size_t d= editDistance(word,nodes_[node].word,row_);
+    if(d==0)
+      return;
+
+    std::uint32_t child= nodes_[node].firstChild;
+    while(child!=none && nodes_[child].distance!=d)
+      child= nodes_[child].nextSibling;
+
+    if(child==none)
+    {
+      nodes_.push_back({word,d,none,nodes_[node].firstChild});
+      nodes_[node].firstChild= std::uint32_t(nodes_.size()-1);
+      return;
+    }
+    node= child;
+  }
+}
+//----------------------------------------------------------------------------
+template<typename CharT>
+std::vector<typename BkTree<CharT>::Match>
+BkTree<CharT>::find(StringView word,
+                    std::size_t maxDistance,
+                    std::size_t count)const
+{
+  std::vector<Match> matches;
+  if(nodes_.empty() || count==0)
+    return matches;
+
+  const auto nearer= [](const Match& a, const Match& b)
+  {
+    return a.distance!=b.distance ? a.distance<b.distance : a.word<b.word;
+  };
+
+  std::vector<std::size_t> row;
+  std::size_t bound= maxDistance;
+  std::vector<std::uint32_t> stack{0};
+  while(!stack.empty())
+  {
+    const Node& node= nodes_[stack.back()];
+    stack.pop_back();
+
+    const std::size_t d= editDistance(word,node.word,row);
+    if(d<=bound)
+    {
+      const Match match{node.word,d};
+      matches.insert(std::upper_bound(matches.begin(),matches.end(),
+                                      match,nearer),match);
+      if(matches.size()>count)
+        matches.pop_back();
+      // farther words can not get in any more
+      if(matches.size()==count)
+        bound= matches.back().distance;
+    }
+
+    for(std::uint32_t child=node.firstChild; child!=none;
+        child= nodes_[child].nextSibling)
+    {
+      const std::size_t e= nodes_[child].distance;
+      if(e+bound>=d && e<=d+bound)
+        stack.push_back(child);
+    }
+  }
+  return matches;
+}
+//----------------------------------------------------------------------------
+} // end namespace detail
+//----------------------------------------------------------------------------
+}
+//----------------------------------------------------------------------------
+#endif // BKTREE_H
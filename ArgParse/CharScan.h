@@ -0,0 +1,182 @@
+#ifndef CHARSCAN_H
+#define CHARSCAN_H
+//----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+//----------------------------------------------------------------------------
+// SSE2/AVX2 scanners on x86, both macros are #undef'd at the end
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+  #define STRINGUTILS_SIMD_X86
+  #include <immintrin.h>
+  #ifdef _MSC_VER
+    #include <intrin.h>
+  #endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+  #define STRINGUTILS_TARGET(ISA) __attribute__((target(ISA)))
+#else
+  #define STRINGUTILS_TARGET(ISA)
+#endif
+//----------------------------------------------------------------------------
+namespace StringUtils
+{
+//----------------------------------------------------------------------------
+namespace detail
+{
+//----------------------------------------------------------------------------
+// Whitespace of the "C" locale: ' ', '\t', '\n', '\v', '\f', '\r'
+constexpr bool isCSpace(char c)
+{
+  return c==' ' || (c>='\t' && c<='\r');
+}
+//----------------------------------------------------------------------------
+// Index of the first whitespace or '"' in [pos, size), or size.
+// All implementations return the same result.
+//----------------------------------------------------------------------------
+inline std::size_t findSpaceOrQuoteScalar(const char* s,
+                                          std::size_t size,
+                                          std::size_t pos)
+{
+  for(; pos<size; ++pos)
+  {
+    if(isCSpace(s[pos]) || s[pos]=='"')
+      return pos;
+  }
+  return size;
+}
+//----------------------------------------------------------------------------
+#ifdef STRINGUTILS_SIMD_X86
+//----------------------------------------------------------------------------
+inline unsigned countTrailingZeros(std::uint32_t mask)
+{
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index,mask);
+  return index;
+#else
+  return __builtin_ctz(mask);
+#endif
+}
+//----------------------------------------------------------------------------
+STRINGUTILS_TARGET("sse2")
+inline std::size_t findSpaceOrQuoteSse2(const char* s,
+                                        std::size_t size,
+                                        std::size_t pos)
+{
+  const __m128i space= _mm_set1_epi8(' ');
+  const __m128i quote= _mm_set1_epi8('"');
+  const __m128i tab  = _mm_set1_epi8('\t');
+  const __m128i four = _mm_set1_epi8(4);   // '\r'-'\t'
+
+  for(; pos+16<=size; pos+=16)
+  {
+    const __m128i c= _mm_loadu_si128(reinterpret_cast<const __m128i*>(s+pos));
+    const __m128i d= _mm_sub_epi8(c,tab);  // '\t'..'\r' -> 0..4
+    const __m128i mask=
+      _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(c,space),
+                                _mm_cmpeq_epi8(c,quote)),
+                   _mm_cmpeq_epi8(_mm_min_epu8(d,four),d));
+
+    const std::uint32_t bits= static_cast<std::uint32_t>(_mm_movemask_epi8(mask));
+    if(bits!=0)
+      return pos+countTrailingZeros(bits);
+  }
+  return findSpaceOrQuoteScalar(s,size,pos);
+}
+//----------------------------------------------------------------------------
+STRINGUTILS_TARGET("avx2")
+inline std::size_t findSpaceOrQuoteAvx2(const char* s,
+                                        std::size_t size,
+                                        std::size_t pos)
+{
+  const __m256i space= _mm256_set1_epi8(' ');
+  const __m256i quote= _mm256_set1_epi8('"');
+  const __m256i tab  = _mm256_set1_epi8('\t');
+  const __m256i four = _mm256_set1_epi8(4);
+
+  for(; pos+32<=size; pos+=32)
+  {
+    const __m256i c= _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s+pos));
+    const __m256i d= _mm256_sub_epi8(c,tab);
+    const __m256i mask=
+      _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(c,space),
+                                      _mm256_cmpeq_epi8(c,quote)),
+                      _mm256_cmpeq_epi8(_mm256_min_epu8(d,four),d));
+
+    const std::uint32_t bits= static_cast<std::uint32_t>(_mm256_movemask_epi8(mask));
+    if(bits!=0)
+      return pos+countTrailingZeros(bits);
+  }
+  return findSpaceOrQuoteSse2(s,size,pos);
+}
+//----------------------------------------------------------------------------
+inline bool cpuHasSse2()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+  return true; // part of x86-64
+#elif defined(_MSC_VER)
+  int info[4];
+  __cpuid(info,1);
+  return (info[3] & (1<<26))!=0;
+#else
+  return __builtin_cpu_supports("sse2");
+#endif
+}
+//----------------------------------------------------------------------------
+inline bool cpuHasAvx2()
+{
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid(info,0);
+  if(info[0]<7)
+    return false;
+
+  __cpuid(info,1);
+  const bool osxsave= (info[2] & (1<<27))!=0;
+  const bool avx    = (info[2] & (1<<28))!=0;
+  if(!osxsave || !avx || (_xgetbv(0) & 0x6)!=0x6) // OS saves YMM
+    return false;
+
+  __cpuidex(info,7,0);
+  return (info[1] & (1<<5))!=0;
+#else
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+//----------------------------------------------------------------------------
+#endif // STRINGUTILS_SIMD_X86
+//----------------------------------------------------------------------------
+using FindSpaceOrQuoteFunc= std::size_t(*)(const char*,std::size_t,std::size_t);
+
+// The widest implementation supported by the CPU, selected once
+inline FindSpaceOrQuoteFunc findSpaceOrQuoteFunc()
+{
+  static const FindSpaceOrQuoteFunc func= []()->FindSpaceOrQuoteFunc
+  {
+#ifdef STRINGUTILS_SIMD_X86
+    if(cpuHasAvx2())
+      return &findSpaceOrQuoteAvx2;
+    if(cpuHasSse2())
+      return &findSpaceOrQuoteSse2;
+#endif
+    return &findSpaceOrQuoteScalar;
+  }();
+  return func;
+}
+//----------------------------------------------------------------------------
+inline std::size_t findSpaceOrQuote(const char* s,
+                                    std::size_t size,
+                                    std::size_t pos)
+{
+  return findSpaceOrQuoteFunc()(s,size,pos);
+}
+//----------------------------------------------------------------------------
+} // end namespace detail
+//----------------------------------------------------------------------------
+}
+//----------------------------------------------------------------------------
+#undef STRINGUTILS_TARGET
+#undef STRINGUTILS_SIMD_X86
+//----------------------------------------------------------------------------
+#endif // CHARSCAN_H
@@ -0,0 +1,230 @@
+#ifndef CMDLINEREADER_H
+#define CMDLINEREADER_H
+//----------------------------------------------------------------------------
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <functional>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+//----------------------------------------------------------------------------
+#ifdef _WIN32
+  #include <io.h>
+#else
+  #include <unistd.h>
+#endif
+//----------------------------------------------------------------------------
+#include "ArgumentParser.h"
+//----------------------------------------------------------------------------
+namespace ArgParse
+{
+//----------------------------------------------------------------------------
+//                        CmdLineReader<CharT>
+//----------------------------------------------------------------------------
+// Reads newline delimited command lines from a stream in large blocks.
+// A line break inside quotes belongs to the quoted token. One buffer of
+// at most maxLineLength+blockSize chars is reused for the whole stream.
+template <typename CharT=char>
+class CmdLineReader
+{
+public:
+  using StringView = std::basic_string_view<CharT>;
+  using StringViews= StringContainer<StringView>;
+  using SplitBuffer= StringUtils::SplitBuffer<CharT>;
+  // reads up to n chars to buffer, returns 0 at the end of the stream
+  using ReadFunction= std::function<std::size_t(CharT* buffer,std::size_t n)>;
+
+  static constexpr const std::size_t defaultBlockSize= 64*1024;
+  static constexpr const std::size_t defaultMaxLineLength= 1024*1024;
+
+  explicit CmdLineReader(ReadFunction read,
+                         std::size_t blockSize= defaultBlockSize,
+                         std::size_t maxLineLength= defaultMaxLineLength)
+    :read_(std::move(read)),
+     blockSize_(std::max<std::size_t>(blockSize,1)),
+     maxLineLength_(maxLineLength)
+  {}
+
+  explicit CmdLineReader(std::basic_istream<CharT>& stream,
+                         std::size_t blockSize= defaultBlockSize,
+                         std::size_t maxLineLength= defaultMaxLineLength)
+    :CmdLineReader(
+       [&stream](CharT* buffer, std::size_t n)
+       {
+         stream.read(buffer,std::streamsize(n));
+         return std::size_t(stream.gcount());
+       },
+       blockSize,maxLineLength)
+  {}
+
+  // raw file descriptor, char only
+  explicit CmdLineReader(int fd,
+                         std::size_t blockSize= defaultBlockSize,
+                         std::size_t maxLineLength= defaultMaxLineLength)
+    :CmdLineReader(
+       [fd](CharT* buffer, std::size_t n)
+       {
+         static_assert(std::is_same_v<CharT,char>,
+                       "File descriptors are read as char!");
+         return readFd(fd,buffer,n);
+       },
+       blockSize,maxLineLength)
+  {}
+
+  // next line without the line break, false at the end of the stream;
+  // line is valid until the next call,
+  // throws std::length_error for lines longer than maxLineLength
+  bool nextLine(StringView& line);
+
+  // next line split by the split() rules, nullptr at the end of the stream
+  const StringViews* nextTokens();
+
+  // parses the next line into result (cleared before),
+  // false at the end of the stream;
+  // status.index refers to tokens(), see ArgumentParser::throwError
+  bool parseNext(const ArgumentParser<CharT>& parser,
+                 ParseResult<CharT>& result,
+                 ParseStatus<CharT>& status);
+
+  // tokens of the last nextTokens()/parseNext()
+  const StringViews& tokens()const{ return splitBuffer_.tokens(); }
+
+private:
+  void fill();
+
+  static std::size_t readFd(int fd, char* buffer, std::size_t n);
+
+  ReadFunction read_;
+  std::size_t blockSize_;
+  std::size_t maxLineLength_;
+
+  // [begin_,end_) not consumed, [begin_,scan_) scanned without line end
+  std::vector<CharT> buffer_;
+  std::size_t begin_= 0;
+  std::size_t scan_ = 0;
+  std::size_t end_  = 0;
+  bool inQuote_= false;  // at scan_
+  bool eof_= false;
+
+  SplitBuffer splitBuffer_;
+};
+//----------------------------------------------------------------------------
+template<typename CharT>
+bool CmdLineReader<CharT>::nextLine(StringView& line)
+{
+  using Traits= std::char_traits<CharT>;
+
+  const auto makeLine= [&](const CharT* first, const CharT* last)
+  {
+    if(last!=first && last[-1]==CharT('\r'))
+      --last;
+    line= StringView(first,std::size_t(last-first));
+  };
+
+  for(;;)
+  {
+    const CharT* data= buffer_.data();
+    const CharT* scan= data+scan_;
+    const CharT* last= data+end_;
+
+    // the line ends at the first '\n' after an even count of quotes
+    while(const CharT* lineEnd= Traits::find(scan,std::size_t(last-scan),CharT('\n')))
+    {
+      inQuote_^= (std::count(scan,lineEnd,CharT('"')) & 1)!=0;
+      scan= lineEnd+1;
+      if(!inQuote_)
+      {
+        makeLine(data+begin_,lineEnd);
+        begin_= scan_= std::size_t(scan-data);
+        return true;
+      }
+    }
+    inQuote_^= (std::count(scan,last,CharT('"')) & 1)!=0;
+    scan_= end_;
+
+    if(eof_)
+    {
+      if(begin_==end_)
+        return false;
+
+      makeLine(data+begin_,last);
+      begin_= scan_= end_;
+      inQuote_= false;
+      return true;
+    }
+    fill();
+  }
+}
+//----------------------------------------------------------------------------
+template<typename CharT>
+void CmdLineReader<CharT>::fill()
+{
+  // keep the not consumed part only
+  if(begin_!=0)
+  {
+    std::copy(buffer_.begin()+begin_,buffer_.begin()+end_,buffer_.begin());
+    end_-= begin_;
+    scan_-= begin_;
+    begin_= 0;
+  }
+
+  if(end_>maxLineLength_)
+    throw std::length_error("CmdLineReader: line is too long");
+
+  if(buffer_.size()<end_+blockSize_)
+    buffer_.resize(end_+blockSize_);
+
+  const std::size_t n= read_(buffer_.data()+end_,blockSize_);
+  if(n==0)
+    eof_= true;
+  end_+= n;
+}
+//----------------------------------------------------------------------------
+template<typename CharT>
+std::size_t CmdLineReader<CharT>::readFd(int fd, char* buffer, std::size_t n)
+{
+  for(;;)
+  {
+#ifdef _WIN32
+    const int count= ::_read(fd,buffer,unsigned(std::min<std::size_t>(n,INT_MAX)));
+#else
+    const auto count= ::read(fd,buffer,n);
+#endif
+    if(count>=0)
+      return std::size_t(count);
+    if(errno!=EINTR)
+      throw std::system_error(errno,std::generic_category(),"CmdLineReader");
+  }
+}
+//----------------------------------------------------------------------------
+template<typename CharT>
+const typename CmdLineReader<CharT>::StringViews*
+CmdLineReader<CharT>::nextTokens()
+{
+  StringView line;
+  if(!nextLine(line))
+    return nullptr;
+  return &splitBuffer_.split(line);
+}
+//----------------------------------------------------------------------------
+template<typename CharT>
+bool CmdLineReader<CharT>::parseNext(const ArgumentParser<CharT>& parser,
+                                     ParseResult<CharT>& result,
+                                     ParseStatus<CharT>& status)
+{
+  const StringViews* tokens= nextTokens();
+  if(!tokens)
+    return false;
+
+  result.clear();
+  status= parser.tryParseArgs(*tokens,result);
+  return true;
+}
+//----------------------------------------------------------------------------
+}
+//----------------------------------------------------------------------------
+#endif // CMDLINEREADER_H
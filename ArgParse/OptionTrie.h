@@ -0,0 +1,191 @@
+#ifndef OPTIONTRIE_H
+#define OPTIONTRIE_H
+//----------------------------------------------------------------------------
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+//----------------------------------------------------------------------------
+namespace ArgParse
+{
+//----------------------------------------------------------------------------
+namespace detail
+{
+//----------------------------------------------------------------------------
+//                        OptionTrie<CharT>
+//----------------------------------------------------------------------------
+// Compressed trie of option strings for the lookup of abbreviations.
+// Edge labels are views of the inserted keys, which must outlive the trie.
+// Each node keeps the value shared by all keys of its subtree, so a prefix
+// is resolved in one walk of its chars.
+template<typename CharT>
+class OptionTrie
+{
+public:
+  using StringView= std::basic_string_view<CharT>;
+
+  static constexpr const std::size_t npos= std::size_t(-1);
+  static constexpr const std::size_t ambiguous= npos-1;
+
+  explicit OptionTrie(std::pmr::memory_resource* resource=
+                          std::pmr::get_default_resource())
+    :nodes_(1,Node(),resource)
+  {}
+
+  void insert(StringView key, std::size_t value);
+  void clear(){ nodes_.resize(1); nodes_[0]= Node(); }
+
+  // value of the keys starting with prefix,
+  // npos for none, ambiguous for different values
+  std::size_t findPrefix(StringView prefix)const
+  {
+    const std::uint32_t node= findNode(prefix);
+    return node==none ? npos : nodes_[node].value;
+  }
+
+  // keys starting with prefix in lexicographic order
+  template<typename OutputIt>
+  OutputIt keysWithPrefix(StringView prefix, OutputIt out)const
+  {
+    const std::uint32_t node= findNode(prefix);
+    return node==none ? out : writeKeys(nodes_[node].firstChild,
+                                        writeKey(node,out));
+  }
+
+private:
+  static constexpr const std::uint32_t none= std::uint32_t(-1);
+
+  struct Node
+  {
+    StringView label;         // edge from the parent
+    StringView key;           // key ending here, empty for inner nodes
+    std::size_t value= npos;  // of the whole subtree
+    std::uint32_t firstChild = none;
+    std::uint32_t nextSibling= none; // ordered by the first label char
+  };
+
+  std::uint32_t newNode(StringView label, std::size_t value)
+  {
+    Node node;
+    node.label= label;
+    node.value= value;
+    nodes_.push_back(node);
+    return std::uint32_t(nodes_.size()-1);
+  }
+
+  // link to the child with the label starting with c or to its place
+  std::uint32_t* findChild(std::uint32_t node, CharT c)
+  {
+    std::uint32_t* link= &nodes_[node].firstChild;
+    while(*link!=none && nodes_[*link].label[0]<c)
+      link= &nodes_[*link].nextSibling;
+    return link;
+  }
+
+  // node where prefix ends, on an edge the node below it
+  std::uint32_t findNode(StringView prefix)const;
+
+  template<typename OutputIt>
+  OutputIt writeKey(std::uint32_t node, OutputIt out)const
+  {
+    if(!nodes_[node].key.empty())
+      *out++= nodes_[node].key;
+    return out;
+  }
+
+  template<typename OutputIt>
+  OutputIt writeKeys(std::uint32_t child, OutputIt out)const
+  {
+    for(; child!=none; child= nodes_[child].nextSibling)
+      out= writeKeys(nodes_[child].firstChild,writeKey(child,out));
+    return out;
+  }
+
+  std::pmr::vector<Node> nodes_; // nodes_[0] is the root
+};
+//----------------------------------------------------------------------------
+template<typename CharT>
+void OptionTrie<CharT>::insert(StringView key, std::size_t value)
+{
+  std::uint32_t node= 0;
+  std::size_t pos= 0;
+  for(;;)
+  {
+    Node& current= nodes_[node];
+    current.value= (current.value==npos || current.value==value)
+                     ? value : ambiguous;
+
+    if(pos==key.size())
+    {
+      current.key= key;
+      return;
+    }
+
+    std::uint32_t* link= findChild(node,key[pos]);
+    if(*link==none || nodes_[*link].label[0]!=key[pos])
+    {
+      const std::uint32_t next= *link;
+      const std::uint32_t leaf= newNode(key.substr(pos),value);
+      nodes_[leaf].key= key;
+      nodes_[leaf].nextSibling= next;
+      // the link is invalidated by newNode()
+      *findChild(node,key[pos])= leaf;
+      return;
+    }
+
+    const std::uint32_t child= *link;
+    const StringView label= nodes_[child].label;
+    const StringView rest= key.substr(pos);
+    std::size_t common= 1;
+    while(common<label.size() && common<rest.size() && label[common]==rest[common])
+      ++common;
+
+    if(common<label.size())
+    {
+      // split the edge, the new node takes the place of child
+      const std::uint32_t middle= newNode(label.substr(0,common),
+                                          nodes_[child].value);
+      *findChild(node,key[pos])= middle;
+      nodes_[middle].firstChild = child;
+      nodes_[middle].nextSibling= nodes_[child].nextSibling;
+      nodes_[child].nextSibling= none;
+      nodes_[child].label= label.substr(common);
+      node= middle;
+    }
+    else
+      node= child;
+    pos+= common;
+  }
+}
+//----------------------------------------------------------------------------
+template<typename CharT>
+std::uint32_t OptionTrie<CharT>::findNode(StringView prefix)const
+{
+  std::uint32_t node= 0;
+  std::size_t pos= 0;
+  while(pos<prefix.size())
+  {
+    std::uint32_t child= nodes_[node].firstChild;
+    while(child!=none && nodes_[child].label[0]<prefix[pos])
+      child= nodes_[child].nextSibling;
+    if(child==none || nodes_[child].label[0]!=prefix[pos])
+      return none;
+
+    const StringView label= nodes_[child].label;
+    const std::size_t n= std::min(label.size(),prefix.size()-pos);
+    if(label.substr(0,n)!=prefix.substr(pos,n))
+      return none;
+
+    pos+= n;
+    node= child;
+  }
+  return node;
+}
+//----------------------------------------------------------------------------
+} // end namespace detail
+//----------------------------------------------------------------------------
+}
+//----------------------------------------------------------------------------
+#endif // OPTIONTRIE_H
@@ -0,0 +1,152 @@
+#ifndef PARSESTATS_H
+#define PARSESTATS_H
+//----------------------------------------------------------------------------
+#include <array>
+#include <chrono>
+#include <cstdint>
+//----------------------------------------------------------------------------
+namespace ArgParse
+{
+//----------------------------------------------------------------------------
+// Parse phases measured by ParseStats
+enum class ParsePhase
+{
+  tokenize,       // split of the command line, count: tokens
+  classify,       // token kinds, count: tokens
+  subParser,      // sub parser dispatch, count: sub parsers
+  optionalLookup, // option string lookup, count: lookups
+  positional,     // positional values distribution, count: values and visited positionals
+  conversion,     // values conversion and checks, count: values
+  requiredCheck,  // required optionals check, count: checked args
+  other           // rest of the parse, count: parses
+};
+
+constexpr const std::size_t parsePhaseCount=
+    std::size_t(ParsePhase::other)+1;
+//----------------------------------------------------------------------------
+struct PhaseStats
+{
+  std::uint64_t count= 0;
+  std::chrono::nanoseconds time{0};  // exclusive of nested phases
+
+  PhaseStats& operator+=(const PhaseStats& other)
+  {
+    count+= other.count;
+    time+= other.time;
+    return *this;
+  }
+};
+//----------------------------------------------------------------------------
+// Time and counts of each parse phase, filled only when the library
+// is compiled with ARGPARSE_INSTRUMENTATION defined, otherwise all
+// recording calls are empty and stay zero.
+// The macro changes the bodies of inline functions: define it for the
+// whole program (add_compile_definitions(), -D for every TU), never for
+// some TUs only, that would break the one definition rule.
+// ParseResult::stats() holds the stats of the last parse,
+// sum them with += to aggregate many parses.
+class ParseStats
+{
+public:
+#ifdef ARGPARSE_INSTRUMENTATION
+  static constexpr const bool enabled= true;
+#else
+  static constexpr const bool enabled= false;
+#endif
+
+  const PhaseStats& operator[](ParsePhase phase)const
+  {
+    return phases_[std::size_t(phase)];
+  }
+
+  std::chrono::nanoseconds totalTime()const
+  {
+    std::chrono::nanoseconds total{0};
+    for(const auto& phase: phases_)
+      total+= phase.time;
+    return total;
+  }
+
+  ParseStats& operator+=(const ParseStats& other)
+  {
+    for(std::size_t i=0; i<parsePhaseCount; ++i)
+      phases_[i]+= other.phases_[i];
+    return *this;
+  }
+
+  void clear(){ *this= ParseStats(); }
+
+  // recording, used by the parser
+
+  void count(ParsePhase phase, std::uint64_t n= 1)
+  {
+    if constexpr(enabled)
+      phases_[std::size_t(phase)].count+= n;
+  }
+
+  // starts phase, returns the interrupted one
+  std::size_t enter(ParsePhase phase)
+  {
+    if constexpr(enabled)
+    {
+      charge();
+      const std::size_t previous= active_;
+      active_= std::size_t(phase);
+      return previous;
+    }
+    else
+      return none;
+  }
+
+  void leave(std::size_t previous)
+  {
+    if constexpr(enabled)
+    {
+      charge();
+      active_= previous;
+    }
+  }
+
+private:
+  using Clock= std::chrono::steady_clock;
+  static constexpr const std::size_t none= parsePhaseCount;
+
+  // time since the last switch goes to the active phase
+  void charge()
+  {
+    const auto now= Clock::now();
+    if(active_!=none)
+      phases_[active_].time+= now-start_;
+    start_= now;
+  }
+
+  std::array<PhaseStats,parsePhaseCount> phases_{};
+  std::size_t active_= none;
+  Clock::time_point start_;
+};
+//----------------------------------------------------------------------------
+namespace detail
+{
+// Scope of a phase, nested scopes pause the enclosing phase
+class PhaseTimer
+{
+public:
+  PhaseTimer(ParseStats& stats, ParsePhase phase)
+    :stats_(stats),
+     previous_(stats.enter(phase))
+  {}
+
+  ~PhaseTimer(){ stats_.leave(previous_); }
+
+  PhaseTimer(const PhaseTimer&)= delete;
+  PhaseTimer& operator=(const PhaseTimer&)= delete;
+
+private:
+  ParseStats& stats_;
+  std::size_t previous_;
+};
+} // end namespace detail
+//----------------------------------------------------------------------------
+}
+//----------------------------------------------------------------------------
+#endif // PARSESTATS_H
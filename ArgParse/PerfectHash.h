@@ -0,0 +1,166 @@
+#ifndef PERFECTHASH_H
+#define PERFECTHASH_H
+//----------------------------------------------------------------------------
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+//----------------------------------------------------------------------------
+namespace ArgParse
+{
+//----------------------------------------------------------------------------
+namespace detail
+{
+//----------------------------------------------------------------------------
+// splitmix64 finalizer
+constexpr std::uint64_t mixHash(std::uint64_t x)
+{
+  x^= x>>30; x*= 0xbf58476d1ce4e5b9ull;
+  x^= x>>27; x*= 0x94d049bb133111ebull;
+  x^= x>>31;
+  return x;
+}
+//----------------------------------------------------------------------------
+// FNV-1a over the code units, mixed since FNV leaves
+// the upper bits of short strings poorly distributed
+template<typename CharT>
+constexpr std::uint64_t hashString(std::basic_string_view<CharT> s)
+{
+  std::uint64_t h= 14695981039346656037ull;
+  for(CharT c: s)
+  {
+    h^= std::uint64_t(c);
+    h*= 1099511628211ull;
+  }
+  return mixHash(h);
+}
+//----------------------------------------------------------------------------
+//                        PerfectHash<n>
+//----------------------------------------------------------------------------
+// Minimal perfect hash of n keys known at compile time (hash and displace):
+// the upper half of the key hash selects a bucket, the seed of the bucket
+// is mixed into the hash to get the slot. Seeds are searched by build(),
+// largest buckets first, so that the slots of all keys differ.
+// The key is hashed once by the caller, slot() costs a mix and a modulo.
+template<std::size_t n>
+class PerfectHash
+{
+public:
+  using Hashes= std::array<std::uint64_t,n>;
+
+  static constexpr const std::size_t size= n;
+  static constexpr const std::size_t bucketCount= n!=0 ? n : 1;
+  static constexpr const std::uint32_t maxSeed= 1u<<16;
+
+  // false when some bucket has no seed, e.g. equal hashes
+  static constexpr PerfectHash build(const Hashes& hashes);
+
+  // all keys have different slots
+  constexpr bool verify(const Hashes& hashes)const;
+
+  constexpr bool ok()const{ return ok_; }
+
+  // slot of a key hash in [0, n), n must not be 0
+  constexpr std::size_t slot(std::uint64_t hash)const
+  {
+    return slotOf(hash,seeds_[bucketOf(hash)]);
+  }
+
+private:
+  static constexpr std::size_t bucketOf(std::uint64_t hash)
+  {
+    return std::size_t((hash>>32)%bucketCount);
+  }
+
+  static constexpr std::size_t slotOf(std::uint64_t hash, std::uint32_t seed)
+  {
+    return std::size_t(mixHash(hash+seed*0x9e3779b97f4a7c15ull)%n);
+  }
+
+  std::array<std::uint32_t,bucketCount> seeds_{};
+  bool ok_= false;
+};
+//----------------------------------------------------------------------------
+template<std::size_t n>
+constexpr PerfectHash<n> PerfectHash<n>::build(const Hashes& hashes)
+{
+  PerfectHash hash;
+
+  // keys grouped by bucket: keys[offsets[b] .. offsets[b+1])
+  std::array<std::size_t,bucketCount+1> offsets{};
+  for(std::uint64_t h: hashes)
+    ++offsets[bucketOf(h)+1];
+
+  std::size_t maxBucketSize= 0;
+  for(std::size_t b=0; b<bucketCount; ++b)
+  {
+    if(offsets[b+1]>maxBucketSize)
+      maxBucketSize= offsets[b+1];
+    offsets[b+1]+= offsets[b];
+  }
+
+  std::array<std::size_t,n> keys{};
+  std::array<std::size_t,bucketCount> fill{};
+  for(std::size_t k=0; k<n; ++k)
+  {
+    const std::size_t b= bucketOf(hashes[k]);
+    keys[offsets[b]+fill[b]++]= k;
+  }
+
+  std::array<bool,n> taken{};
+  std::array<std::size_t,n> slots{};
+  for(std::size_t bucketSize=maxBucketSize; bucketSize>0; --bucketSize)
+  {
+    for(std::size_t b=0; b<bucketCount; ++b)
+    {
+      if(offsets[b+1]-offsets[b]!=bucketSize)
+        continue;
+
+      bool placed= false;
+      for(std::uint32_t seed=0; seed<maxSeed && !placed; ++seed)
+      {
+        placed= true;
+        for(std::size_t i=0; i<bucketSize && placed; ++i)
+        {
+          slots[i]= slotOf(hashes[keys[offsets[b]+i]],seed);
+          placed= !taken[slots[i]];
+          for(std::size_t j=0; j<i && placed; ++j)
+            placed= slots[j]!=slots[i];
+        }
+
+        if(placed)
+        {
+          hash.seeds_[b]= seed;
+          for(std::size_t i=0; i<bucketSize; ++i)
+            taken[slots[i]]= true;
+        }
+      }
+
+      if(!placed)
+        return hash;
+    }
+  }
+
+  hash.ok_= true;
+  return hash;
+}
+//----------------------------------------------------------------------------
+template<std::size_t n>
+constexpr bool PerfectHash<n>::verify(const Hashes& hashes)const
+{
+  std::array<bool,n> taken{};
+  for(std::uint64_t h: hashes)
+  {
+    const std::size_t s= slot(h);
+    if(taken[s])
+      return false;
+    taken[s]= true;
+  }
+  return true;
+}
+//----------------------------------------------------------------------------
+} // end namespace detail
+//----------------------------------------------------------------------------
+}
+//----------------------------------------------------------------------------
+#endif // PERFECTHASH_H
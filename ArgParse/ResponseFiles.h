@@ -0,0 +1,279 @@
+#ifndef RESPONSEFILES_H
+#define RESPONSEFILES_H
+//----------------------------------------------------------------------------
+#include <deque>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+//----------------------------------------------------------------------------
+#ifdef _WIN32
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+//----------------------------------------------------------------------------
+#include "ArgumentParser.h"
+//----------------------------------------------------------------------------
+namespace ArgParse
+{
+//----------------------------------------------------------------------------
+namespace detail
+{
+//----------------------------------------------------------------------------
+// Read only memory mapping of a whole file
+class MappedFile
+{
+public:
+  // throws std::system_error
+  explicit MappedFile(const std::string& path);
+  ~MappedFile(){ unmap(); }
+
+  MappedFile(const MappedFile&)= delete;
+  MappedFile& operator=(const MappedFile&)= delete;
+
+  std::string_view view()const{ return std::string_view(data_,size_); }
+
+private:
+  void unmap();
+
+  const char* data_= nullptr;
+  std::size_t size_= 0;
+};
+//----------------------------------------------------------------------------
+#ifdef _WIN32
+//----------------------------------------------------------------------------
+inline MappedFile::MappedFile(const std::string& path)
+{
+  const auto error= []()
+  {
+    return std::system_error(int(GetLastError()),std::system_category());
+  };
+
+  HANDLE file= CreateFileA(path.c_str(),GENERIC_READ,FILE_SHARE_READ,nullptr,
+                           OPEN_EXISTING,FILE_FLAG_SEQUENTIAL_SCAN,nullptr);
+  if(file==INVALID_HANDLE_VALUE)
+    throw error();
+
+  LARGE_INTEGER size;
+  if(!GetFileSizeEx(file,&size))
+  {
+    const auto e= error();
+    CloseHandle(file);
+    throw e;
+  }
+
+  size_= std::size_t(size.QuadPart);
+  if(size_!=0) // empty files can not be mapped
+  {
+    HANDLE mapping= CreateFileMappingA(file,nullptr,PAGE_READONLY,0,0,nullptr);
+    if(mapping)
+    {
+      data_= static_cast<const char*>(MapViewOfFile(mapping,FILE_MAP_READ,0,0,0));
+      CloseHandle(mapping);
+    }
+    if(!data_)
+    {
+      const auto e= error();
+      CloseHandle(file);
+      throw e;
+    }
+  }
+  CloseHandle(file);
+}
+//----------------------------------------------------------------------------
+inline void MappedFile::unmap()
+{
+  if(data_)
+    UnmapViewOfFile(data_);
+}
+//----------------------------------------------------------------------------
+#else
+//----------------------------------------------------------------------------
+inline MappedFile::MappedFile(const std::string& path)
+{
+  const auto error= []()
+  {
+    return std::system_error(errno,std::generic_category());
+  };
+
+  const int fd= ::open(path.c_str(),O_RDONLY);
+  if(fd<0)
+    throw error();
+
+  struct stat info;
+  if(::fstat(fd,&info)!=0)
+  {
+    const auto e= error();
+    ::close(fd);
+    throw e;
+  }
+
+  size_= std::size_t(info.st_size);
+  if(size_!=0) // empty files can not be mapped
+  {
+    void* data= ::mmap(nullptr,size_,PROT_READ,MAP_PRIVATE,fd,0);
+    if(data==MAP_FAILED)
+    {
+      const auto e= error();
+      ::close(fd);
+      throw e;
+    }
+    ::madvise(data,size_,MADV_SEQUENTIAL);
+    data_= static_cast<const char*>(data);
+  }
+  ::close(fd);
+}
+//----------------------------------------------------------------------------
+inline void MappedFile::unmap()
+{
+  if(data_)
+    ::munmap(const_cast<char*>(data_),size_);
+}
+//----------------------------------------------------------------------------
+#endif
+//----------------------------------------------------------------------------
+} // end namespace detail
+//----------------------------------------------------------------------------
+//                        ResponseFileException<CharT>
+//----------------------------------------------------------------------------
+template <typename CharT>
+class ResponseFileException: public Exception<CharT>
+{
+public:
+  using typename Exception<CharT>::String;
+
+  enum class Reason{ cannotOpen, tooDeep };
+
+  ResponseFileException(const String& fileName,
+                        Reason reason,
+                        std::error_code error= std::error_code())
+    :Exception<CharT>(),
+     fileName_(fileName),
+     reason_(reason),
+     error_(error)
+  {
+  }
+
+  virtual String what()const override
+  {
+    using namespace StringUtils::literals;
+    String msg= "response file '"_lv+fileName_+"': "_lv;
+    if(reason_==Reason::tooDeep)
+      return msg+"nesting is too deep"_lv;
+
+    const std::string message= error_.message();
+    return msg+"cannot open: "_lv+StringUtils::LatinView(message.c_str());
+  }
+
+  const String& fileName()const{ return fileName_; }
+  Reason reason()const{ return reason_; }
+  std::error_code error()const{ return error_; }
+
+private:
+  String fileName_;
+  Reason reason_;
+  std::error_code error_;
+};
+//----------------------------------------------------------------------------
+//                        ResponseFiles
+//----------------------------------------------------------------------------
+// Expands "@file" args to the tokens of file, split by the split() rules,
+// a response file can refer to other response files up to maxDepth levels.
+// Files are memory mapped, tokens are views of the mappings (quoted tokens
+// are views of a scratch buffer). Views stay valid until the next expand().
+//
+//   ResponseFiles files;
+//   parser.parseArgs(files.expand(argc,argv));
+//
+class ResponseFiles
+{
+public:
+  using StringView = std::string_view;
+  using StringViews= StringContainer<StringView>;
+
+  explicit ResponseFiles(char prefix= '@', std::size_t maxDepth= 8)
+    :prefix_(prefix),
+     levels_(maxDepth+1)
+  {}
+
+  // throws ResponseFileException<char>
+  const StringViews& expand(const StringViews& args)
+  {
+    files_.clear();
+    scratches_.clear();
+    tokens_.clear();
+    for(StringView arg: args)
+      append(arg,0);
+    return tokens_;
+  }
+
+  const StringViews& expand(int argc, char* argv[])
+  {
+    return expand(StringViews(argv,argv+argc));
+  }
+
+  const StringViews& expand(int argc, const char* argv[])
+  {
+    return expand(StringViews(argv,argv+argc));
+  }
+
+  const StringViews& tokens()const{ return tokens_; }
+
+  std::size_t maxDepth()const{ return levels_.size()-1; }
+
+private:
+  void append(StringView arg, std::size_t depth);
+
+  char prefix_;
+
+  // deques, the addresses of mappings and scratch buffers do not change
+  std::deque<detail::MappedFile> files_;
+  std::deque<std::string> scratches_;
+
+  // tokens of the files being expanded, one per nesting level
+  std::vector<StringViews> levels_;
+  StringViews tokens_;
+};
+//----------------------------------------------------------------------------
+inline void ResponseFiles::append(StringView arg, std::size_t depth)
+{
+  using Exception= ResponseFileException<char>;
+
+  if(arg.size()<2 || arg.front()!=prefix_)
+  {
+    tokens_.push_back(arg);
+    return;
+  }
+
+  const std::string fileName(arg.substr(1));
+  if(depth+1>=levels_.size())
+    throw Exception(fileName,Exception::Reason::tooDeep);
+
+  try
+  {
+    files_.emplace_back(fileName);
+  }
+  catch(const std::system_error& e)
+  {
+    throw Exception(fileName,Exception::Reason::cannotOpen,e.code());
+  }
+
+  StringViews& fileTokens= levels_[depth];
+  StringUtils::splitViews(files_.back().view(),scratches_.emplace_back(),
+                          fileTokens);
+
+  tokens_.reserve(tokens_.size()+fileTokens.size());
+  for(StringView token: fileTokens)
+    append(token,depth+1);
+}
+//----------------------------------------------------------------------------
+}
+//----------------------------------------------------------------------------
+#endif // RESPONSEFILES_H
@@ -0,0 +1,986 @@
+#ifndef STATICPARSER_H
+#define STATICPARSER_H
+//----------------------------------------------------------------------------
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+//----------------------------------------------------------------------------
+#include "ArgumentParser.h"
+#include "PerfectHash.h"
+//----------------------------------------------------------------------------
+namespace ArgParse
+{
+//----------------------------------------------------------------------------
+//                        StaticArg
+//----------------------------------------------------------------------------
+// Compile time description of one arg, made by schema::optional() and
+// schema::positional(). Option strings and texts are views of literals.
+template<typename T,
+         std::size_t minCount,
+         std::size_t maxCount,
+         typename CharT,
+         std::size_t optionCount>
+struct StaticArg
+{
+  static_assert(TypeUtils::TypeInfo<T>::isRegistred,
+                "Not allowed type for arg!");
+
+  static_assert(minCount<=maxCount,
+               "minCount must be less or equal maxCount!");
+
+  using Type= T;
+  using CharType= CharT;
+  using StringView= std::basic_string_view<CharT>;
+
+  static constexpr const std::size_t minCountV= minCount;
+  static constexpr const std::size_t maxCountV= maxCount;
+  static constexpr const bool isOptional= optionCount>0;
+  static constexpr const TypeGroup group=
+      TypeUtils::groupOfMaxCount<T,maxCount,CharT>();
+  static constexpr const bool isSequence=
+      group==TypeGroup::numbers || group==TypeGroup::strings;
+  // string values are read as views of the tokens
+  static constexpr const bool isString=
+      group==TypeGroup::string || group==TypeGroup::strings;
+
+  std::array<StringView,optionCount> optionStrings{};
+  StringView name{};      // positionals only
+  StringView helpText{};
+  bool isRequired= false;
+
+  constexpr StaticArg required(bool required= true)const
+  {
+    StaticArg arg= *this;
+    arg.isRequired= required;
+    return arg;
+  }
+
+  constexpr StaticArg help(StringView help)const
+  {
+    StaticArg arg= *this;
+    arg.helpText= help;
+    return arg;
+  }
+};
+//----------------------------------------------------------------------------
+//                        StaticSchema
+//----------------------------------------------------------------------------
+template<typename CharT, typename... Args>
+struct StaticSchema
+{
+  using CharType= CharT;
+  using StringView= std::basic_string_view<CharT>;
+  using ArgTuple= std::tuple<Args...>;
+
+  static constexpr const std::size_t argCount= sizeof...(Args);
+
+  ArgTuple args;
+  StringView prefixChars;
+
+  constexpr StaticSchema withPrefixChars(StringView chars)const
+  {
+    StaticSchema schema= *this;
+    schema.prefixChars= chars;
+    return schema;
+  }
+};
+//----------------------------------------------------------------------------
+namespace detail
+{
+//----------------------------------------------------------------------------
+template<typename CharT>
+struct DefaultPrefixChars
+{
+  static constexpr const CharT value[]= { CharT('-'), CharT('/') };
+};
+
+template<typename CharT>
+constexpr std::basic_string_view<CharT> defaultPrefixChars()
+{
+  return std::basic_string_view<CharT>(DefaultPrefixChars<CharT>::value,2);
+}
+//----------------------------------------------------------------------------
+template<typename CharT, std::size_t n>
+constexpr std::basic_string_view<CharT> literalView(const CharT (&str)[n])
+{
+  return std::basic_string_view<CharT>(str,n-1);
+}
+//----------------------------------------------------------------------------
+template<typename CharT>
+constexpr bool isDigit(CharT c)
+{
+  return c>=CharT('0') && c<=CharT('9');
+}
+//----------------------------------------------------------------------------
+// the rules of ArgumentParser::classify
+template<typename CharT>
+constexpr bool isPrefixed(std::basic_string_view<CharT> s,
+                          std::basic_string_view<CharT> prefixChars)
+{
+  return s.size()>=2 && prefixChars.find(s[0])!=s.npos;
+}
+
+template<typename CharT>
+constexpr bool isSeparator(std::basic_string_view<CharT> s,
+                           std::basic_string_view<CharT> prefixChars)
+{
+  return isPrefixed(s,prefixChars) && s.size()==2 && s[1]==s[0];
+}
+
+template<typename CharT>
+constexpr bool isOption(std::basic_string_view<CharT> s,
+                        std::basic_string_view<CharT> prefixChars)
+{
+  return isPrefixed(s,prefixChars) && !isDigit(s[1]);
+}
+//----------------------------------------------------------------------------
+template<typename CharT>
+struct StaticOption
+{
+  std::basic_string_view<CharT> option;
+  std::size_t arg;
+};
+//----------------------------------------------------------------------------
+template<const auto& schema>
+constexpr std::size_t optionStringCount()
+{
+  return std::apply([](const auto&... args)
+                    {
+                      return (std::size_t(0)+...+args.optionStrings.size());
+                    },
+                    schema.args);
+}
+//----------------------------------------------------------------------------
+// option strings of all args, sorted to find duplicates
+template<const auto& schema>
+constexpr auto makeOptionTable()
+{
+  using CharT= typename std::decay_t<decltype(schema)>::CharType;
+  using Option= StaticOption<CharT>;
+
+  std::array<Option,optionStringCount<schema>()> table{};
+  std::size_t n= 0;
+  std::size_t arg= 0;
+  std::apply([&](const auto&... args)
+             {
+               ([&](const auto& a)
+                {
+                  for(const auto& option: a.optionStrings)
+                    table[n++]= Option{option,arg};
+                  ++arg;
+                }(args), ...);
+             },
+             schema.args);
+
+  // insertion sort, std::sort is not constexpr
+  for(std::size_t i=1; i<table.size(); ++i)
+  {
+    const Option option= table[i];
+    std::size_t j= i;
+    for(; j>0 && option.option<table[j-1].option; --j)
+      table[j]= table[j-1];
+    table[j]= option;
+  }
+  return table;
+}
+//----------------------------------------------------------------------------
+template<typename Table>
+constexpr bool hasDuplicates(const Table& table)
+{
+  for(std::size_t i=1; i<table.size(); ++i)
+    if(table[i].option==table[i-1].option)
+      return true;
+  return false;
+}
+//----------------------------------------------------------------------------
+template<typename Table, typename StringView>
+constexpr bool allOptions(const Table& table, StringView prefixChars)
+{
+  for(const auto& entry: table)
+    if(!isOption(entry.option,prefixChars))
+      return false;
+  return true;
+}
+//----------------------------------------------------------------------------
+template<typename Table>
+constexpr auto optionHashes(const Table& table)
+{
+  std::array<std::uint64_t,std::tuple_size_v<Table>> hashes{};
+  for(std::size_t i=0; i<table.size(); ++i)
+    hashes[i]= hashString(table[i].option);
+  return hashes;
+}
+//----------------------------------------------------------------------------
+// table entries moved to their slots of the perfect hash
+template<typename Table, typename Hash>
+constexpr Table hashedOptionTable(const Table& table, const Hash& hash)
+{
+  Table hashed{};
+  for(const auto& entry: table)
+    hashed[hash.slot(hashString(entry.option))]= entry;
+  return hashed;
+}
+//----------------------------------------------------------------------------
+// per arg constants indexed by the position of the arg in the schema
+template<const auto& schema, typename F>
+constexpr auto makeArgArray(F f)
+{
+  return std::apply([&](const auto&... args)
+                    {
+                      return std::array<decltype(f(std::get<0>(schema.args))),
+                                        sizeof...(args)>{ f(args)... };
+                    },
+                    schema.args);
+}
+//----------------------------------------------------------------------------
+template<const auto& schema, bool optional>
+constexpr auto makeArgIndices()
+{
+  constexpr auto isOptional= makeArgArray<schema>(
+        [](const auto& arg){ return std::decay_t<decltype(arg)>::isOptional; });
+
+  constexpr std::size_t count= [&]()
+  {
+    std::size_t n= 0;
+    for(bool b: isOptional)
+      n+= b==optional;
+    return n;
+  }();
+
+  std::array<std::size_t,count> indices{};
+  std::size_t n= 0;
+  for(std::size_t i=0; i<isOptional.size(); ++i)
+    if(isOptional[i]==optional)
+      indices[n++]= i;
+  return indices;
+}
+//----------------------------------------------------------------------------
+// converts a token of a validated parse
+template<typename T, typename CharT>
+T staticConvert(std::basic_string_view<CharT> str)
+{
+  T value{};
+  TypeUtils::TypeInfo<T>::tryAssignFromString(str,value);
+  return value;
+}
+
+template<typename Arg>
+ErrorCode staticValidate(typename Arg::StringView str)
+{
+  if constexpr(Arg::isString)
+  {
+    return ErrorCode::none;
+  }
+  else
+  {
+    typename Arg::Type value{};
+    const std::errc ec= TypeUtils::TypeInfo<typename Arg::Type>::
+                          tryAssignFromString(str,value);
+    if(ec==std::errc::result_out_of_range)
+      return ErrorCode::outOfRange;
+    if(ec!=std::errc())
+      return ErrorCode::invalidArgument;
+    return ErrorCode::none;
+  }
+}
+//----------------------------------------------------------------------------
+// argv or an array of views
+template<typename CharT>
+struct StaticTokens
+{
+  const CharT* const* argv= nullptr;
+  const std::basic_string_view<CharT>* views= nullptr;
+
+  std::basic_string_view<CharT> operator[](std::size_t i)const
+  {
+    return views ? views[i] : std::basic_string_view<CharT>(argv[i]);
+  }
+};
+//----------------------------------------------------------------------------
+} // end namespace detail
+//----------------------------------------------------------------------------
+//                        schema
+//----------------------------------------------------------------------------
+// Factories of the compile time schema, nargs as for ArgumentParser:
+//
+//   static constexpr auto cli= schema::make(
+//       schema::positional<std::string>("input"),
+//       schema::optional<int>("-n","--number").required(),
+//       schema::optional<double,'+'>("-w","--weights").help("weights"));
+//
+//   StaticParser<cli> parser;
+//
+namespace schema
+{
+//----------------------------------------------------------------------------
+// minCount, maxCount
+template<typename T,
+         std::size_t minCount,
+         std::size_t maxCount,
+         typename CharT,
+         std::size_t... n>
+constexpr auto optional(const CharT (&... optionStrings)[n])
+{
+  static_assert(sizeof...(n)>0, "arg must have option strings!");
+  return StaticArg<T,minCount,maxCount,CharT,sizeof...(n)>
+      {{detail::literalView(optionStrings)...}};
+}
+
+// nargs
+template<typename T,
+         NArgs nargs= NArgs::optional,
+         typename CharT,
+         std::size_t... n>
+constexpr auto optional(const CharT (&... optionStrings)[n])
+{
+  constexpr const std::size_t maxCount= std::numeric_limits<std::size_t>::max();
+
+  if constexpr(nargs==NArgs::optional)
+    return optional<T,0,1>(optionStrings...);
+  else if constexpr(nargs==NArgs::zeroOrMore)
+    return optional<T,0,maxCount>(optionStrings...);
+  else
+    return optional<T,1,maxCount>(optionStrings...);
+}
+
+// char nargs
+template<typename T,
+         char nargs,
+         typename CharT,
+         std::size_t... n>
+constexpr auto optional(const CharT (&... optionStrings)[n])
+{
+  static_assert( nargs=='?' || nargs=='*' || nargs=='+',
+      "Error: wrong nargs option!");
+
+  if constexpr(nargs=='?')
+    return optional<T,NArgs::optional>(optionStrings...);
+  else if constexpr(nargs=='*')
+    return optional<T,NArgs::zeroOrMore>(optionStrings...);
+  else
+    return optional<T,NArgs::oneOrMore>(optionStrings...);
+}
+//----------------------------------------------------------------------------
+// minCount, maxCount
+template<typename T,
+         std::size_t minCount,
+         std::size_t maxCount,
+         typename CharT,
+         std::size_t n>
+constexpr auto positional(const CharT (&name)[n])
+{
+  StaticArg<T,minCount,maxCount,CharT,0> arg{};
+  arg.name= detail::literalView(name);
+  return arg;
+}
+
+// nargs
+template<typename T,
+         NArgs nargs= NArgs::optional,
+         typename CharT,
+         std::size_t n>
+constexpr auto positional(const CharT (&name)[n])
+{
+  constexpr const std::size_t maxCount= std::numeric_limits<std::size_t>::max();
+
+  if constexpr(nargs==NArgs::optional)
+    return positional<T,0,1>(name);
+  else if constexpr(nargs==NArgs::zeroOrMore)
+    return positional<T,0,maxCount>(name);
+  else
+    return positional<T,1,maxCount>(name);
+}
+
+// char nargs
+template<typename T,
+         char nargs,
+         typename CharT,
+         std::size_t n>
+constexpr auto positional(const CharT (&name)[n])
+{
+  static_assert( nargs=='?' || nargs=='*' || nargs=='+',
+      "Error: wrong nargs option!");
+
+  if constexpr(nargs=='?')
+    return positional<T,NArgs::optional>(name);
+  else if constexpr(nargs=='*')
+    return positional<T,NArgs::zeroOrMore>(name);
+  else
+    return positional<T,NArgs::oneOrMore>(name);
+}
+//----------------------------------------------------------------------------
+// prefix chars are "-/" as for ArgumentParser, see withPrefixChars()
+template<typename Arg, typename... Args>
+constexpr auto make(const Arg& arg, const Args&... args)
+{
+  using CharT= typename Arg::CharType;
+  static_assert((std::is_same_v<CharT,typename Args::CharType> && ...),
+                "All args must have the same char type!");
+
+  return StaticSchema<CharT,Arg,Args...>{
+      {arg,args...}, detail::defaultPrefixChars<CharT>()};
+}
+//----------------------------------------------------------------------------
+} // end namespace schema
+//----------------------------------------------------------------------------
+//                        StaticParseStatus
+//----------------------------------------------------------------------------
+struct StaticParseStatus
+{
+  static constexpr const std::size_t npos= std::size_t(-1);
+
+  ErrorCode error= ErrorCode::none;
+  std::size_t index= npos;  // offending token, npos for argumentRequired
+  std::size_t count= 0;     // offending tokens count from index
+  std::size_t arg= npos;    // position of the offending arg in the schema
+
+  bool ok()const{ return error==ErrorCode::none; }
+  explicit operator bool()const{ return ok(); }
+};
+//----------------------------------------------------------------------------
+//                        StaticValues
+//----------------------------------------------------------------------------
+// Values of a sequence arg, converted from the tokens by each read
+template<typename T, typename CharT>
+class StaticValues
+{
+public:
+  using StringView= std::basic_string_view<CharT>;
+  using value_type= std::conditional_t<TypeUtils::IsBasicStringV<T,CharT>,
+                                       StringView, T>;
+
+  class const_iterator
+  {
+  public:
+    using iterator_category= std::forward_iterator_tag;
+    using value_type= StaticValues::value_type;
+    using difference_type= std::ptrdiff_t;
+    using pointer= void;
+    using reference= value_type;
+
+    const_iterator(const StaticValues* values, std::size_t k)
+      :values_(values), k_(k)
+    {}
+
+    value_type operator*()const{ return (*values_)[k_]; }
+    const_iterator& operator++(){ ++k_; return *this; }
+    const_iterator operator++(int){ auto it= *this; ++k_; return it; }
+
+    bool operator==(const const_iterator& other)const{ return k_==other.k_; }
+    bool operator!=(const const_iterator& other)const{ return k_!=other.k_; }
+
+  private:
+    const StaticValues* values_;
+    std::size_t k_;
+  };
+
+  StaticValues(detail::StaticTokens<CharT> tokens,
+               std::size_t first, std::size_t count,
+               std::size_t headCount, std::size_t tailFirst)
+    :tokens_(tokens), first_(first), count_(count),
+     headCount_(headCount), tailFirst_(tailFirst)
+  {}
+
+  std::size_t size()const{ return count_; }
+  bool empty()const{ return count_==0; }
+
+  value_type operator[](std::size_t k)const
+  {
+    const std::size_t i= first_+k;
+    const StringView token= tokens_[i<headCount_ ? i : tailFirst_+(i-headCount_)];
+    if constexpr(TypeUtils::IsBasicStringV<T,CharT>)
+      return token;
+    else
+      return detail::staticConvert<T>(token);
+  }
+
+  const_iterator begin()const{ return const_iterator(this,0); }
+  const_iterator end()const{ return const_iterator(this,count_); }
+
+private:
+  detail::StaticTokens<CharT> tokens_;
+  std::size_t first_;
+  std::size_t count_;
+
+  // value index -> token index, see StaticParser::position()
+  std::size_t headCount_;
+  std::size_t tailFirst_;
+};
+//----------------------------------------------------------------------------
+//                        StaticParser
+//----------------------------------------------------------------------------
+// Parser of a schema known at compile time. Option strings are checked
+// and placed by a perfect hash by the compiler, nothing is allocated:
+// values are read from the tokens, which must outlive the reads. Parse
+// rules and help layout are the ones of ArgumentParser, except that
+// a repeated option keeps its last values. Sub parsers and ranges are
+// not supported.
+template<const auto& schema>
+class StaticParser
+{
+  using Schema= std::decay_t<decltype(schema)>;
+
+public:
+  using CharT= typename Schema::CharType;
+  using StringView= std::basic_string_view<CharT>;
+
+  static constexpr const std::size_t argCount= Schema::argCount;
+  static constexpr const std::size_t npos= StaticParseStatus::npos;
+
+  template<std::size_t i>
+  using ArgAt= std::tuple_element_t<i,typename Schema::ArgTuple>;
+
+  // argv must outlive the reads of values
+  StaticParseStatus tryParseArgs(int argc, const CharT* const argv[])
+  {
+    return parse({argv,nullptr},std::size_t(argc));
+  }
+
+  StaticParseStatus tryParseArgs(const StringView* tokens, std::size_t count)
+  {
+    return parse({nullptr,tokens},count);
+  }
+
+  template<std::size_t i>
+  bool exists()const{ return spans_[i].exists; }
+
+  // values count of arg i
+  template<std::size_t i>
+  std::size_t count()const{ return spans_[i].count; }
+
+  // single value, strings are views of the token
+  template<std::size_t i>
+  auto value()const
+  {
+    using Arg= ArgAt<i>;
+    static_assert(!Arg::isSequence, "Use values() for sequences!");
+
+    using ValueType= std::conditional_t<Arg::isString,
+                                        StringView,typename Arg::Type>;
+    if(spans_[i].count==0)
+      return std::optional<ValueType>();
+
+    const StringView token= tokens_[tokenIndex<i>(spans_[i].first)];
+    if constexpr(Arg::isString)
+      return std::optional<ValueType>(token);
+    else
+      return std::optional<ValueType>(
+          detail::staticConvert<typename Arg::Type>(token));
+  }
+
+  template<std::size_t i>
+  StaticValues<typename ArgAt<i>::Type,CharT> values()const
+  {
+    using Arg= ArgAt<i>;
+    static_assert(Arg::isSequence, "Use value() for single values!");
+
+    if constexpr(Arg::isOptional)
+      return {tokens_,spans_[i].first,spans_[i].count,npos,0};
+    else
+      return {tokens_,spans_[i].first,spans_[i].count,headCount_,tailFirst_};
+  }
+
+  template<typename OutputIt>
+  static OutputIt writeUsage(OutputIt out);
+
+  template<typename OutputIt>
+  static OutputIt writeHelp(OutputIt out);
+
+private:
+  static constexpr const auto optionTable= detail::makeOptionTable<schema>();
+  static_assert(!detail::hasDuplicates(optionTable),
+                "Option string is used twice!");
+  static_assert(detail::allOptions(optionTable,schema.prefixChars),
+                "Option strings must start with a prefix char!");
+
+  static constexpr const auto optionHash=
+      detail::PerfectHash<optionTable.size()>::build(
+        detail::optionHashes(optionTable));
+  static_assert(optionHash.ok() &&
+                optionHash.verify(detail::optionHashes(optionTable)),
+                "No perfect hash of the option strings!");
+  static constexpr const auto hashedOptions=
+      detail::hashedOptionTable(optionTable,optionHash);
+
+  static constexpr const auto optionalIndices= detail::makeArgIndices<schema,true>();
+  static constexpr const auto positionalIndices= detail::makeArgIndices<schema,false>();
+
+  static constexpr const auto minCounts= detail::makeArgArray<schema>(
+      [](const auto& arg){ return std::decay_t<decltype(arg)>::minCountV; });
+  static constexpr const auto maxCounts= detail::makeArgArray<schema>(
+      [](const auto& arg){ return std::decay_t<decltype(arg)>::maxCountV; });
+  static constexpr const auto required= detail::makeArgArray<schema>(
+      [](const auto& arg){ return arg.isRequired; });
+
+  static constexpr const std::size_t positionalsMinCount= [](){
+    std::size_t sum= 0;
+    for(std::size_t i: positionalIndices)
+      sum+= minCounts[i];
+    return sum;
+  }();
+
+  using ValidateFunction= ErrorCode(*)(StringView);
+
+  template<std::size_t... i>
+  static constexpr std::array<ValidateFunction,argCount>
+      makeValidators(std::index_sequence<i...>)
+  {
+    return {{ &detail::staticValidate<ArgAt<i>>... }};
+  }
+
+  static constexpr const std::array<ValidateFunction,argCount> validators=
+      makeValidators(std::make_index_sequence<argCount>());
+
+  // tokens of arg values: [first,first+count) for optionals,
+  // positional value indexes for positionals
+  struct Span
+  {
+    std::size_t first= 0;
+    std::size_t count= 0;
+    bool exists= false;
+  };
+
+  template<std::size_t i>
+  std::size_t tokenIndex(std::size_t k)const
+  {
+    if constexpr(ArgAt<i>::isOptional)
+      return k;
+    else
+      return position(k);
+  }
+
+  // k-th positional value -> token index
+  std::size_t position(std::size_t k)const
+  {
+    return k<headCount_ ? k : tailFirst_+(k-headCount_);
+  }
+
+  static std::size_t findOption(StringView option);
+
+  StaticParseStatus parse(detail::StaticTokens<CharT> tokens, std::size_t count);
+  StaticParseStatus assignValues(std::size_t arg, std::size_t first,
+                                 std::size_t count, bool positional);
+
+  template<typename OutputIt>
+  static OutputIt writeName(OutputIt out, std::size_t arg, std::size_t count);
+
+  template<typename OutputIt>
+  static OutputIt writeHelpLine(OutputIt out, std::size_t arg);
+
+  std::array<Span,argCount> spans_{};
+  detail::StaticTokens<CharT> tokens_;
+  std::size_t headCount_= 0;
+  std::size_t tailFirst_= 0;
+};
+//----------------------------------------------------------------------------
+template<const auto& schema>
+std::size_t StaticParser<schema>::findOption(StringView option)
+{
+  // one hash and one compare
+  if constexpr(hashedOptions.size()==0)
+    return npos;
+  else
+  {
+    const auto& entry= hashedOptions[optionHash.slot(detail::hashString(option))];
+    return entry.option==option ? entry.arg : npos;
+  }
+}
+//----------------------------------------------------------------------------
+template<const auto& schema>
+StaticParseStatus StaticParser<schema>::assignValues(std::size_t arg,
+                                                     std::size_t first,
+                                                     std::size_t count,
+                                                     bool positional)
+{
+  const auto tokenAt= [&](std::size_t k){ return positional ? position(k) : k; };
+
+  if(count<minCounts[arg] || count>maxCounts[arg])
+    return {ErrorCode::wrongCount,tokenAt(first),count,arg};
+
+  for(std::size_t k=first; k<first+count; ++k)
+  {
+    const std::size_t index= tokenAt(k);
+    const ErrorCode error= validators[arg](tokens_[index]);
+    if(error!=ErrorCode::none)
+      return {error,index,1,arg};
+  }
+
+  // a repeated option keeps the values of its last occurrence
+  spans_[arg].first= first;
+  spans_[arg].count= count;
+  return {};
+}
+//----------------------------------------------------------------------------
+template<const auto& schema>
+StaticParseStatus StaticParser<schema>::parse(detail::StaticTokens<CharT> tokens,
+                                              std::size_t count)
+{
+  using namespace std;
+  constexpr const StringView prefixChars= schema.prefixChars;
+
+  spans_= {};
+  tokens_= tokens;
+
+  // [0, endOfPositional) positional values
+  // [endOfPositional, separator) optional args
+  // (separator, count) positional values after "--"
+  size_t separator= 0;
+  while(separator<count && !detail::isSeparator(tokens[separator],prefixChars))
+    ++separator;
+
+  size_t endOfPositional= 0;
+  while(endOfPositional<separator &&
+        !detail::isOption(tokens[endOfPositional],prefixChars))
+    ++endOfPositional;
+
+  headCount_= endOfPositional;
+  tailFirst_= separator==count ? count : separator+1;
+
+  // positionals
+  size_t totalCount= headCount_+(count-tailFirst_);
+  size_t shouldRemain= positionalsMinCount;
+  size_t k= 0;
+  for(size_t arg: positionalIndices)
+  {
+    spans_[arg].exists= true;
+
+    // sum of minCount of the next positionals
+    shouldRemain-= minCounts[arg];
+
+    const size_t available= (shouldRemain > totalCount)
+        ? totalCount
+        : totalCount-shouldRemain;
+
+    const size_t n= std::min(maxCounts[arg],available);
+    const auto status= assignValues(arg,k,n,true);
+    if(!status.ok())
+      return status;
+
+    k+= n;
+    totalCount-= n;
+  }
+
+  if(totalCount!=0)
+  {
+    const size_t index= position(k);
+    return {ErrorCode::unrecognizedArguments,index,
+            (tailFirst_==count ? endOfPositional : count)-index,npos};
+  }
+
+  // optionals
+  size_t it= endOfPositional;
+  while(it!=separator)
+  {
+    const size_t arg= detail::isOption(tokens[it],prefixChars)
+                        ? findOption(tokens[it]) : npos;
+    if(arg==npos)
+      return {ErrorCode::unrecognizedArguments,it,separator-it,npos};
+
+    spans_[arg].exists= true;
+    const size_t optionIndex= it++;
+
+    size_t valueCount= 0;
+    while(it+valueCount<separator &&
+          !detail::isOption(tokens[it+valueCount],prefixChars))
+      ++valueCount;
+
+    const size_t n= std::min(valueCount,maxCounts[arg]);
+    auto status= assignValues(arg,it,n,false);
+    if(!status.ok())
+    {
+      if(status.error==ErrorCode::wrongCount)
+        status.index= optionIndex;
+      return status;
+    }
+    it+= n;
+  }
+
+  for(size_t arg: optionalIndices)
+  {
+    if(required[arg] && !spans_[arg].exists)
+      return {ErrorCode::argumentRequired,npos,0,arg};
+  }
+  return {};
+}
+//----------------------------------------------------------------------------
+// name of arg repeated count times, as repeatString() does
+template<const auto& schema>
+template<typename OutputIt>
+OutputIt StaticParser<schema>::writeName(OutputIt out,
+                                         std::size_t arg,
+                                         std::size_t count)
+{
+  using namespace StringUtils::literals;
+  using StringUtils::writeString;
+
+  StringView name;
+  bool upper= false;
+  std::apply([&](const auto&... args)
+             {
+               std::size_t i= 0;
+               ([&](const auto& a)
+                {
+                  if(i++!=arg)
+                    return;
+                  if constexpr(std::decay_t<decltype(a)>::isOptional)
+                  {
+                    // as detail::optionName(): the last option with
+                    // two prefix chars without them, the first otherwise
+                    name= a.optionStrings.front();
+                    for(StringView s: a.optionStrings)
+                      if(schema.prefixChars.find(s[1])!=s.npos)
+                        name= s.substr(2);
+                    upper= true;
+                  }
+                  else
+                    name= a.name;
+                }(args), ...);
+             },
+             schema.args);
+
+  const auto writeOnce= [&]()
+  {
+    for(CharT c: name)
+      *out++= upper ? CharT(std::toupper(c)) : c;
+  };
+
+  constexpr const std::size_t maxCount= 5;
+  const std::size_t m= count<=maxCount ? count : 2;
+
+  writeOnce();
+  for(std::size_t i=1; i<m; ++i)
+  {
+    *out++= CharT(' ');
+    writeOnce();
+  }
+  if(count>maxCount)
+  {
+    out= writeString(out," ... "_lv);
+    writeOnce();
+  }
+  return out;
+}
+//----------------------------------------------------------------------------
+template<const auto& schema>
+template<typename OutputIt>
+OutputIt StaticParser<schema>::writeUsage(OutputIt out)
+{
+  using namespace StringUtils::literals;
+  using StringUtils::writeString;
+
+  bool first= true;
+  std::size_t arg= 0;
+  const auto writeArg= [&](const auto& a, bool optionals)
+  {
+    using Arg= std::decay_t<decltype(a)>;
+    if(Arg::isOptional==optionals)
+    {
+      if(!first)
+        *out++= CharT(' ');
+      first= false;
+
+      if constexpr(Arg::isOptional)
+      {
+        out= writeString(out,"["_lv);
+        out= writeString(out,a.optionStrings.front());
+        *out++= CharT(' ');
+        out= writeName(out,arg,Arg::minCountV);
+        out= writeString(out,"]"_lv);
+      }
+      else
+        out= writeName(out,arg,Arg::minCountV);
+    }
+    ++arg;
+  };
+
+  for(const bool optionals: {true,false})
+  {
+    arg= 0;
+    std::apply([&](const auto&... args){ (writeArg(args,optionals), ...); },
+               schema.args);
+  }
+  return out;
+}
+//----------------------------------------------------------------------------
+template<const auto& schema>
+template<typename OutputIt>
+OutputIt StaticParser<schema>::writeHelpLine(OutputIt out, std::size_t arg)
+{
+  using namespace StringUtils::literals;
+  using StringUtils::writeString;
+
+  std::size_t i= 0;
+  const auto writeArg= [&](const auto& a)
+  {
+    using Arg= std::decay_t<decltype(a)>;
+    if(i++!=arg)
+      return;
+
+    if constexpr(Arg::isOptional)
+    {
+      bool first= true;
+      for(StringView optionString: a.optionStrings)
+      {
+        if(!first)
+          out= writeString(out,", "_lv);
+        first= false;
+
+        out= writeString(out,optionString);
+        *out++= CharT(' ');
+        out= writeName(out,arg,Arg::minCountV);
+      }
+    }
+    else
+      out= writeString(out,a.name);
+
+    if(!a.helpText.empty())
+    {
+      *out++= CharT(' ');
+      out= writeString(out,a.helpText);
+    }
+  };
+
+  std::apply([&](const auto&... args){ (writeArg(args), ...); },schema.args);
+  return out;
+}
+//----------------------------------------------------------------------------
+template<const auto& schema>
+template<typename OutputIt>
+OutputIt StaticParser<schema>::writeHelp(OutputIt out)
+{
+  using namespace StringUtils::literals;
+  using StringUtils::writeString;
+
+  if(!positionalIndices.empty())
+  {
+    out= writeString(out,"positional arguments:\n"_lv);
+    for(std::size_t arg: positionalIndices)
+    {
+      out= writeString(out,"    "_lv);
+      out= writeString(writeHelpLine(out,arg),"\n"_lv);
+    }
+    *out++= CharT('\n');
+  }
+
+  if(!optionalIndices.empty())
+  {
+    out= writeString(out,"optional arguments:\n"_lv);
+    for(std::size_t arg: optionalIndices)
+    {
+      out= writeString(out,"    "_lv);
+      out= writeString(writeHelpLine(out,arg),"\n"_lv);
+    }
+  }
+  return out;
+}
+//----------------------------------------------------------------------------
+}
+//----------------------------------------------------------------------------
+#endif // STATICPARSER_H
@@ -2,6 +2,7 @@
 #define STRINGUTILS_H
 //----------------------------------------------------------------------------
 #include <string>
+#include <string_view>
 #include <vector>
 #include <limits>
 #include <stdexcept>
@@ -10,8 +11,12 @@
 #include <numeric>
 #include <cctype>
 #include <cerrno>
+#include <charconv>
+#include <system_error>
+#include <type_traits>
 //----------------------------------------------------------------------------
 #include "LatinView.h"
+#include "CharScan.h"
 //----------------------------------------------------------------------------
 namespace StringUtils
 {
@@ -19,21 +24,26 @@ namespace StringUtils
 namespace detail
 {
 template<typename T, typename D=T,typename CharT, typename F, typename WF>
-D convert(const std::basic_string<CharT>& s,
+std::errc tryConvert(std::basic_string_view<CharT> sv,
+   D& result,
    [[maybe_unused]] F f,
    [[maybe_unused]] WF wf)
 {
   using namespace  std;
 
-  using FT1= T(*)(const char *, char **, int);  // std::strtol, std::strtoll, ...
-  using FT2= T(*)(const char *, char **);       // std::strtof,  std::strtod, ...
+  const basic_string<CharT> s(sv); // null-terminated copy for f/wf
 
-  using WFT1= T(*)(const wchar_t *, wchar_t **, int); // std::wcstol, ...
-  using WFT2= T(*)(const wchar_t *, wchar_t **);      // std::wcstof, ...
+  // std::strtol, std::strtoll, ... / std::strtof,  std::strtod, ...
+  constexpr bool isFT1= is_invocable_r_v<T,F,const char *, char **, int>;
+  constexpr bool isFT2= is_invocable_r_v<T,F,const char *, char **>;
 
-  static_assert(is_same_v<F,FT1>   || is_same_v<F,FT2>,
+  // std::wcstol, ... / std::wcstof, ...
+  constexpr bool isWFT1= is_invocable_r_v<T,WF,const wchar_t *, wchar_t **, int>;
+  constexpr bool isWFT2= is_invocable_r_v<T,WF,const wchar_t *, wchar_t **>;
+
+  static_assert(isFT1  || isFT2,
                 "f expected signature T(const char *, char **[, int])");
-  static_assert(is_same_v<WF,WFT1> || is_same_v<WF,WFT2>,
+  static_assert(isWFT1 || isWFT2,
                 "wf expected signature T(const wchar_t *, wchar_t **[, int])");
 
   errno= 0;
@@ -42,14 +52,14 @@ D convert(const std::basic_string<CharT>& s,
   T value;
   if constexpr(is_same_v<CharT,char>)
   {
-    if constexpr( is_same_v<F,FT1>)
+    if constexpr(isFT1)
       value= f(s.c_str(), &last, 10); // FT1
     else
       value= f(s.c_str(), &last);     // FT2   floating
   }
   else
   {
-    if constexpr(is_same_v<WF,WFT1>)
+    if constexpr(isWFT1)
       value= wf(s.c_str(), &last, 10); // WFT1
     else
       value= wf(s.c_str(), &last);     // WFT2 floating
@@ -59,98 +69,228 @@ D convert(const std::basic_string<CharT>& s,
       value==numeric_limits<T>::lowest()) &&
      errno==ERANGE)
   {
-    throw out_of_range("out of range(errno=ERANGE)");
+    return errc::result_out_of_range;
   }
 
   if(last!=end)
-    throw invalid_argument("invalid argument");
+    return errc::invalid_argument;
 
   if(is_unsigned_v<T> && s[0] == CharT('-'))
-    throw out_of_range("out of range");
+    return errc::result_out_of_range;
+
+  if constexpr(!is_same_v<T,D>)
+  {
+    if(value < numeric_limits<D>::lowest() ||
+       value > numeric_limits<D>::max())
+      return errc::result_out_of_range;
+  }
+
+  result= static_cast<D>(value);
+  return errc();
+};
+//----------------------------------------------------------------------------
+// std::out_of_range for errc::result_out_of_range,
+// std::invalid_argument for other errors
+inline void throwIfError(std::errc ec)
+{
+  if(ec==std::errc::result_out_of_range)
+    throw std::out_of_range("out of range");
+  if(ec!=std::errc())
+    throw std::invalid_argument("invalid argument");
+}
+//----------------------------------------------------------------------------
+template<typename T, typename D=T,typename CharT, typename F, typename WF>
+D convert(std::basic_string_view<CharT> sv, F f, WF wf)
+{
+  D value{};
+  throwIfError(tryConvert<T>(sv,value,f,wf));
+  return value;
+};
+//----------------------------------------------------------------------------
+#ifdef __cpp_lib_to_chars
+constexpr const bool hasFloatFromChars= true;
+#else
+constexpr const bool hasFloatFromChars= false; // integers only
+#endif
+//----------------------------------------------------------------------------
+// Locale independent, allocation free conversion of the whole string.
+// Accepts what strtol/strtod accept for a token, except leading whitespace
+// and hex floats; returns errc::invalid_argument or errc::result_out_of_range
+template<typename T>
+std::errc fromChars(std::string_view s, T& value)
+{
+  using namespace std;
 
-  if constexpr(is_same_v<T,D>)
+  const char* first= s.data();
+  const char* last = first+s.size();
+
+  if(first!=last && *first=='+')
+  {
+    ++first;
+    if(first!=last && *first=='-')
+      return errc::invalid_argument;
+  }
+  else if constexpr(is_unsigned_v<T>)
   {
-    return value;
+    if(first!=last && *first=='-') // "-1" is out of range, not invalid
+    {
+      const errc ec= fromChars(string_view(first+1,last-first-1),value);
+      return ec==errc() ? errc::result_out_of_range : ec;
+    }
   }
+
+  from_chars_result result;
+  if constexpr(is_floating_point_v<T>)
+    result= from_chars(first,last,value,chars_format::general);
   else
+    result= from_chars(first,last,value);
+
+  if(result.ec!=errc())
+    return result.ec;
+  if(result.ptr!=last)
+    return errc::invalid_argument;
+  return errc();
+}
+//----------------------------------------------------------------------------
+template<typename T>
+T convertFromChars(std::string_view s)
+{
+  T value{};
+  throwIfError(fromChars(s,value));
+  return value;
+}
+//----------------------------------------------------------------------------
+template<typename>
+constexpr const bool dependentFalse= false;
+//----------------------------------------------------------------------------
+}  // end namespace detail
+//----------------------------------------------------------------------------
+// Non-throwing conversion of the whole string s to value,
+// returns errc::invalid_argument or errc::result_out_of_range on error
+// and leaves value unchanged
+//----------------------------------------------------------------------------
+template<typename CharT, typename T>
+std::errc tryStrTo(std::basic_string_view<CharT> s, T& value)
+{
+  using namespace std;
+  using detail::tryConvert;
+
+  constexpr bool isChar= is_same_v<CharT,char>;
+
+  if constexpr(is_same_v<T,bool>)
   {
-    if(value < numeric_limits<D>::lowest() &&
-       value > numeric_limits<D>::max())
-      throw out_of_range("out of range");
+    using namespace literals;
+    const auto equal= [s](LatinView lv)
+    {
+      return std::equal(s.begin(),s.end(),lv.begin(),lv.end());
+    };
 
-    return static_cast<D>(value);
+    if(equal("true"_lv)  || equal("1"_lv))
+      value= true;
+    else if(equal("false"_lv) || equal("0"_lv))
+      value= false;
+    else
+      return errc::invalid_argument;
+    return errc();
   }
-};
+  else if constexpr(is_same_v<T,basic_string<CharT>>)
+  {
+    value.assign(s.data(),s.size());
+    return errc();
+  }
+  else if constexpr(isChar && is_integral_v<T>)
+    return detail::fromChars(s,value);
+  else if constexpr(isChar && detail::hasFloatFromChars &&
+                    (is_same_v<T,float> || is_same_v<T,double>))
+    return detail::fromChars(s,value);
+  else if constexpr(is_same_v<T,int>)
+    return tryConvert<long>(s,value,strtol,wcstol);
+  else if constexpr(is_same_v<T,unsigned int>)
+    return tryConvert<unsigned long>(s,value,strtoul,wcstoul);
+  else if constexpr(is_same_v<T,long>)
+    return tryConvert<long>(s,value,strtol,wcstol);
+  else if constexpr(is_same_v<T,unsigned long>)
+    return tryConvert<unsigned long>(s,value,strtoul,wcstoul);
+  else if constexpr(is_same_v<T,long long>)
+    return tryConvert<long long>(s,value,strtoll,wcstoll);
+  else if constexpr(is_same_v<T,unsigned long long>)
+    return tryConvert<unsigned long long>(s,value,strtoull,wcstoull);
+  else if constexpr(is_same_v<T,float>)
+    return tryConvert<float>(s,value,strtof,wcstof);
+  else if constexpr(is_same_v<T,double>)
+    return tryConvert<double>(s,value,strtod,wcstod);
+  else if constexpr(is_same_v<T,long double>)
+    return tryConvert<long double>(s,value,strtold,wcstold);
+  else
+    static_assert(detail::dependentFalse<T>, "Not supported type!");
+}
 //----------------------------------------------------------------------------
-}  // end namespace detail
+template<typename T, typename CharT>
+T strTo(std::basic_string_view<CharT> s)
+{
+  T value{};
+  detail::throwIfError(tryStrTo(s,value));
+  return value;
+}
 //----------------------------------------------------------------------------
 template<typename CharT>
-bool strToBool(const std::basic_string<CharT>& s)
+bool strToBool(std::basic_string_view<CharT> s)
 {
-  using namespace literals;
-  if(s=="true"_lv  || s=="1"_lv)
-    return true;
-  else if(s=="false"_lv || s=="0"_lv)
-    return false;
-
-  throw std::invalid_argument("Can not convert string to bool");
+  return strTo<bool>(s);
 }
 
 template<typename CharT>
-auto strToInt(const std::basic_string<CharT>& s)
+auto strToInt(std::basic_string_view<CharT> s)
 {
-  return detail::convert<long,int>(s,std::strtol,std::wcstol);
+  return strTo<int>(s);
 };
 
 template<typename CharT>
-auto strToUInt(const std::basic_string<CharT>& s)
+auto strToUInt(std::basic_string_view<CharT> s)
 {
-  return
-    detail::convert<unsigned long,unsigned int>(s,std::strtoul,std::wcstoul);
+  return strTo<unsigned int>(s);
 };
 
 template<typename CharT>
-auto strToLong(const std::basic_string<CharT>& s)
+auto strToLong(std::basic_string_view<CharT> s)
 {
-  return
-    detail::convert<long>(s,std::strtol,std::wcstol);
+  return strTo<long>(s);
 };
 
 template<typename CharT>
-auto strToULong(const std::basic_string<CharT>& s)
+auto strToULong(std::basic_string_view<CharT> s)
 {
-  return detail::convert<unsigned long>(s,std::strtoul,std::wcstoul);
+  return strTo<unsigned long>(s);
 };
 
 template<typename CharT>
-auto strToLongLong(const std::basic_string<CharT>& s)
+auto strToLongLong(std::basic_string_view<CharT> s)
 {
-  return detail::convert<long long>(s,std::strtoll,std::wcstoll);
+  return strTo<long long>(s);
 };
 
 template<typename CharT>
-auto strToULongLong(const std::basic_string<CharT>& s)
+auto strToULongLong(std::basic_string_view<CharT> s)
 {
-  return detail::convert<unsigned long long>(s,std::strtoull,std::wcstoull);
+  return strTo<unsigned long long>(s);
 };
 
 template<typename CharT>
-auto strToFloat(const std::basic_string<CharT>& s)
+auto strToFloat(std::basic_string_view<CharT> s)
 {
-  return detail::convert<float>(s,std::strtof,std::wcstof);
+  return strTo<float>(s);
 };
 
 template<typename CharT>
-auto strToDouble(std::basic_string<CharT> s)
+auto strToDouble(std::basic_string_view<CharT> s)
 {
-  return detail::convert<double>(s,std::strtod,std::wcstod);
+  return strTo<double>(s);
 };
 
 template<typename CharT>
-auto strToLongDouble(const std::basic_string<CharT>& s)
+auto strToLongDouble(std::basic_string_view<CharT> s)
 {
-  return
-     detail::convert<long double>(s,std::strtold,std::wcstold);
+  return strTo<long double>(s);
 };
 //----------------------------------------------------------------------------
 template <typename CharT,typename Number>
@@ -164,45 +304,116 @@ inline int isQuote(int c)
   return c=='"';
 }
 //----------------------------------------------------------------------------
-template<typename CharT,
-         typename Strings=std::vector<std::basic_string<CharT>>>
-Strings split(const std::basic_string<CharT> &str)
+// Splits str into tokens without copying:
+// a token without quotes is a view of str,
+// a quoted token is unquoted into scratch and is a view of scratch.
+// Views are valid until str changes or the next call with the same scratch.
+template<typename CharT>
+void splitViews(std::basic_string_view<CharT> str,
+                std::basic_string<CharT>& scratch,
+                std::vector<std::basic_string_view<CharT>>& tokens)
 {
   using namespace std;
-  using String = basic_string<CharT>;
+  using StringView = basic_string_view<CharT>;
 
-  Strings result;
-  String  current;
-  bool quoted= false;
+  tokens.clear();
+  scratch.clear();
+  scratch.reserve(str.size()); // no reallocation, views of scratch stay valid
 
-  auto first=
-    find_if_not(cbegin(str),cend(str),[](auto c){return isspace(c);});
+  constexpr bool isChar= is_same_v<CharT,char>;
 
-  while(true)
+  const auto isSpace= [](auto c)
   {
-    if(first==cend(str))
-    {
-      if(!current.empty())
-        result.push_back(current);
-      return result;
-    }
-    else if(!quoted && isspace(*first))
+    if constexpr(isChar)
+      return detail::isCSpace(c);
+    else
+      return isspace(c)!=0;
+  };
+
+  const size_t length= str.size();
+
+  // next whitespace or quote, vectorized for char
+  const auto findStop= [&](size_t pos)
+  {
+    if constexpr(isChar)
+      return detail::findSpaceOrQuote(str.data(),length,pos);
+    else
+      return size_t(find_if(str.begin()+pos,str.end(),
+               [&](auto c){ return isSpace(c) || isQuote(c); })-str.begin());
+  };
+
+  size_t i= find_if_not(str.begin(),str.end(),isSpace)-str.begin();
+  while(i<length)
+  {
+    const size_t first= i;
+    size_t scratchFirst= StringView::npos;
+    bool quoted= false;
+
+    while(true)
     {
-      result.push_back(current);
-      current.clear();
-      first= find_if_not(first, cend(str),[](auto c){return isspace(c);});
-      continue;
+      const size_t stop= quoted ? std::min(str.find(CharT('"'),i),length)
+                                : findStop(i);
+      if(scratchFirst!=StringView::npos)
+        scratch.append(str.data()+i,stop-i);
+
+      i= stop;
+      if(i==length || !isQuote(str[i]))
+        break;
+
+      if(scratchFirst==StringView::npos)
+      {
+        scratchFirst= scratch.size();
+        scratch.append(str.data()+first,i-first);
+      }
+      quoted= !quoted;
+      ++i;
     }
-    else
+
+    const StringView token= (scratchFirst==StringView::npos)
+        ? str.substr(first,i-first)
+        : StringView(scratch.data()+scratchFirst,scratch.size()-scratchFirst);
+
+    if(i==length)
     {
-      if(isQuote(*first))
-        quoted= !quoted;
-      else
-        current+= *first;
-      ++first;
+      if(!token.empty())
+        tokens.push_back(token);
+      return;
     }
+
+    tokens.push_back(token);
+    i= find_if_not(str.begin()+i,str.end(),isSpace)-str.begin();
   }
-  return result;
+}
+//----------------------------------------------------------------------------
+// Reusable buffers for splitViews,
+// a steady-state split does not allocate
+template<typename CharT>
+class SplitBuffer
+{
+public:
+  using StringView = std::basic_string_view<CharT>;
+  using StringViews= std::vector<StringView>;
+
+  const StringViews& split(StringView str)
+  {
+    splitViews(str,scratch_,tokens_);
+    return tokens_;
+  }
+
+  const StringViews& tokens()const{ return tokens_; }
+
+private:
+  std::basic_string<CharT> scratch_;
+  StringViews tokens_;
+};
+//----------------------------------------------------------------------------
+template<typename CharT,
+         typename Strings=std::vector<std::basic_string<CharT>>>
+Strings split(const std::basic_string<CharT> &str)
+{
+  SplitBuffer<CharT> buffer;
+  const auto& tokens= buffer.split(str);
+  return Strings(std::cbegin(tokens),std::cend(tokens));
 }
 //----------------------------------------------------------------------------
 template <typename String>
@@ -516,6 +727,37 @@ auto repeatString(const String& str,
    return out;
 };
 //----------------------------------------------------------------------------
+// Output iterator versions, without intermediate strings
+//----------------------------------------------------------------------------
+template <typename OutputIt, typename String>
+OutputIt writeString(OutputIt out, const String& str)
+{
+  return std::copy(std::cbegin(str),std::cend(str),out);
+}
+//----------------------------------------------------------------------------
+// repeatString() written to out
+template <typename OutputIt, typename String, typename D= LatinView>
+OutputIt writeRepeated(OutputIt out,
+                       const String& str,
+                       std::size_t count,
+                       std::size_t maxCount= 5,
+                       D delemiter= LatinView(" "))
+{
+  out= writeString(out,str);
+
+  const std::size_t m= count<=maxCount? count : 2;
+  for(std::size_t i=1; i<m; ++i)
+    out= writeString(writeString(out,delemiter),str);
+
+  if(count>maxCount)
+  {
+    out= writeString(out,delemiter);
+    out= writeString(out,LatinView("..."));
+    out= writeString(writeString(out,delemiter),str);
+  }
+  return out;
+}
+//----------------------------------------------------------------------------
 }
 //----------------------------------------------------------------------------
 #endif // STRINGUTILS_H
@@ -3,6 +3,8 @@
 //----------------------------------------------------------------
 #include <type_traits>
 #include <string>
+#include <string_view>
+#include <system_error>
 //----------------------------------------------------------------
 #include "StringUtils.h"
 //----------------------------------------------------------------
@@ -27,7 +29,9 @@ struct TypeCounter<0>
    static constexpr const std::size_t value= 0;
 };
 //----------------------------------------------------------------
-#define TI_REGISTER_TYPE(TYPE, TYPE_NAME, ASSIGN_FROM_STRING)  \
+// values are converted by StringUtils::tryStrTo(),
+// an overload of it must exist for TYPE
+#define TI_REGISTER_TYPE(TYPE, TYPE_NAME)  \
     template<> \
     struct TypeCounter<__LINE__> \
     { \
@@ -37,33 +41,34 @@ struct TypeCounter<0>
     template <>  \
     struct TypeInfo<TYPE> \
     {\
-       template <typename String> \
-       static TYPE assignFromString(String&& s) \
+       template <typename CharT> \
+       static std::errc tryAssignFromString(std::basic_string_view<CharT> s, \
+                                            TYPE& value) \
        { \
-         return (ASSIGN_FROM_STRING)(std::forward<String>(s)); \
+         return StringUtils::tryStrTo(s,value); \
        } \
        static constexpr const char * name = TYPE_NAME; \
        static constexpr const bool isRegistred = true; \
        static constexpr const std::size_t id = TypeCounter<__LINE__>::value;\
     };
 //----------------------------------------------------------------
-TI_REGISTER_TYPE(bool, "bool", StringUtils::strToBool);
+TI_REGISTER_TYPE(bool, "bool");
 
-TI_REGISTER_TYPE(int,      "int",      StringUtils::strToInt);
-TI_REGISTER_TYPE(unsigned, "unsigned", StringUtils::strToUInt);
+TI_REGISTER_TYPE(int,      "int");
+TI_REGISTER_TYPE(unsigned, "unsigned");
 
-TI_REGISTER_TYPE(long,          "long",          StringUtils::strToLong);
-TI_REGISTER_TYPE(unsigned long, "unsinged long", StringUtils::strToULong);
+TI_REGISTER_TYPE(long,          "long");
+TI_REGISTER_TYPE(unsigned long, "unsinged long");
 
-TI_REGISTER_TYPE(long long,          "long long",          StringUtils::strToLongLong);
-TI_REGISTER_TYPE(unsigned long long, "unsinged long long", StringUtils::strToULongLong);
+TI_REGISTER_TYPE(long long,          "long long");
+TI_REGISTER_TYPE(unsigned long long, "unsinged long long");
 
-TI_REGISTER_TYPE(float,       "float",      StringUtils::strToFloat);
-TI_REGISTER_TYPE(double,      "double",     StringUtils::strToDouble);
-TI_REGISTER_TYPE(long double, "long double",StringUtils::strToLongDouble);
+TI_REGISTER_TYPE(float,       "float");
+TI_REGISTER_TYPE(double,      "double");
+TI_REGISTER_TYPE(long double, "long double");
 
-TI_REGISTER_TYPE(std::string,  "string",  [](auto s){ return s; } );
-TI_REGISTER_TYPE(std::wstring, "wstring", [](auto s){ return s; } );
+TI_REGISTER_TYPE(std::string,  "string");
+TI_REGISTER_TYPE(std::wstring, "wstring");
 //----------------------------------------------------------------
 #undef TI_REGISTER_TYPE
 //----------------------------------------------------------------
@@ -0,0 +1,405 @@
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <functional>
+//------------------------------------------------------------------
+#include "../../ArgParse/ArgumentParser.h"
+//------------------------------------------------------------------
+// Benchmark suite of all parse phases, results as CSV or JSON.
+//
+//   argparse_bench --format json --schema 10 1000 --argv 16 4096
+//
+// schema: args count of the parser, argv: tokens count of the input.
+//------------------------------------------------------------------
+namespace
+{
+//------------------------------------------------------------------
+using namespace std;
+using Clock= chrono::steady_clock;
+//------------------------------------------------------------------
+struct Row
+{
+  string phase;
+  size_t schema;
+  size_t argv;
+  size_t iterations;
+  double nsPerOp;    // one call of the measured function
+  double nsPerItem;  // nsPerOp / items processed by the call
+};
+//------------------------------------------------------------------
+// calls f until minTime is spent, doubling the iterations count
+Row measure(const string& phase, size_t schema, size_t argv, size_t items,
+            chrono::nanoseconds minTime, const function<void()>& f)
+{
+  size_t iterations= 1;
+  for(;;)
+  {
+    const auto start= Clock::now();
+    for(size_t i=0; i<iterations; ++i)
+      f();
+    const auto elapsed= Clock::now()-start;
+
+    if(elapsed>=minTime || iterations>=(size_t(1)<<30))
+    {
+      const double ns= chrono::duration<double,nano>(elapsed).count()/
+                       double(iterations);
+      return {phase,schema,argv,iterations,ns,ns/double(max<size_t>(items,1))};
+    }
+    iterations*= 2;
+  }
+}
+//------------------------------------------------------------------
+using Parser= ArgParse::ArgumentParser<char>;
+using ArgParse::ParseResult;
+//------------------------------------------------------------------
+string optionName(size_t i){ return "--option"+to_string(i); }
+//------------------------------------------------------------------
+void benchSplit(vector<Row>& rows, size_t argv, chrono::nanoseconds minTime)
+{
+  string cmdLine;
+  for(size_t i=0; i<argv; ++i)
+    cmdLine+= (i%8==0) ? "\"quoted value "+to_string(i)+"\" "
+                       : "value"+to_string(i)+" ";
+
+  rows.push_back(measure("split",0,argv,argv,minTime,[&]
+  {
+    const auto tokens= StringUtils::split(cmdLine);
+    if(tokens.size()!=argv) abort();
+  }));
+
+  StringUtils::SplitBuffer<char> buffer;
+  rows.push_back(measure("split_views",0,argv,argv,minTime,[&]
+  {
+    if(buffer.split(cmdLine).size()!=argv) abort();
+  }));
+}
+//------------------------------------------------------------------
+void benchLookup(vector<Row>& rows, size_t schema, size_t argv,
+                 chrono::nanoseconds minTime)
+{
+  Parser parser;
+  for(size_t i=0; i<schema; ++i)
+    parser.addOptional<int>(optionName(i));
+
+  vector<string> args;
+  for(size_t i=0; i<argv; ++i)
+    args.push_back(optionName(schema-1-(i*schema/argv)%schema));
+  const Parser::StringViews views(cbegin(args),cend(args));
+
+  ParseResult<char> result;
+  rows.push_back(measure("option_lookup",schema,argv,argv,minTime,[&]
+  {
+    result.clear();
+    if(!parser.tryParseArgs(views,result)) abort();
+  }));
+}
+//------------------------------------------------------------------
+void benchAbbrev(vector<Row>& rows, size_t schema, size_t argv,
+                 chrono::nanoseconds minTime)
+{
+  Parser parser;
+  parser.setAllowAbbrev(true);
+  for(size_t i=0; i<schema; ++i)
+    parser.addOptional<int>(optionName(i)+"-long");
+
+  // unique prefixes, never exact option strings
+  vector<string> args;
+  for(size_t i=0; i<argv; ++i)
+    args.push_back(optionName(schema-1-(i*schema/argv)%schema)+"-l");
+  const Parser::StringViews views(cbegin(args),cend(args));
+
+  ParseResult<char> result;
+  rows.push_back(measure("abbrev_lookup",schema,argv,argv,minTime,[&]
+  {
+    result.clear();
+    if(!parser.tryParseArgs(views,result)) abort();
+  }));
+}
+//------------------------------------------------------------------
+void benchReset(vector<Row>& rows, size_t schema, chrono::nanoseconds minTime)
+{
+  Parser parser;
+  for(size_t i=0; i<schema; ++i)
+    parser.addOptional<int>(optionName(i));
+
+  // a command touches two options
+  const vector<string> args{optionName(0),"1",optionName(schema-1),"2"};
+  const Parser::StringViews views(cbegin(args),cend(args));
+
+  rows.push_back(measure("reset",schema,args.size(),1,minTime,[&]
+  {
+    parser.reset();
+    if(!parser.tryParseArgs(views)) abort();
+  }));
+}
+//------------------------------------------------------------------
+void benchPositional(vector<Row>& rows, size_t schema, size_t argv,
+                     chrono::nanoseconds minTime)
+{
+  Parser parser;
+  for(size_t i=0; i<schema; ++i)
+  {
+    if(i%2==0)
+      parser.addPositional<string,'*'>("p"+to_string(i));
+    else
+      parser.addPositional<string,'?'>("p"+to_string(i));
+  }
+
+  vector<string> args;
+  for(size_t i=0; i<argv; ++i)
+    args.push_back("v"+to_string(i));
+  const Parser::StringViews views(cbegin(args),cend(args));
+
+  ParseResult<char> result;
+  rows.push_back(measure("positional",schema,argv,argv,minTime,[&]
+  {
+    result.clear();
+    if(!parser.tryParseArgs(views,result)) abort();
+  }));
+}
+//------------------------------------------------------------------
+// one value per positional, ns per item must not grow with schema
+void benchPositionalScaling(vector<Row>& rows, size_t schema,
+                            chrono::nanoseconds minTime)
+{
+  Parser parser;
+  for(size_t i=0; i<schema; ++i)
+    parser.addPositional<int,'?'>("p"+to_string(i));
+
+  vector<string> args;
+  for(size_t i=0; i<schema; ++i)
+    args.push_back(to_string(i));
+  const Parser::StringViews views(cbegin(args),cend(args));
+
+  ParseResult<char> result;
+  rows.push_back(measure("positional_scaling",schema,schema,schema,minTime,[&]
+  {
+    if(!parser.tryParseArgs(views,result)) abort();
+  }));
+}
+//------------------------------------------------------------------
+void benchConvert(vector<Row>& rows, size_t argv, chrono::nanoseconds minTime)
+{
+  vector<string> ints, doubles;
+  for(size_t i=0; i<argv; ++i)
+  {
+    ints.push_back(to_string(int(i*7919)-100000));
+    doubles.push_back(to_string(double(i)*1.25e-3));
+  }
+
+  long sum= 0;
+  rows.push_back(measure("convert_strtol",0,argv,argv,minTime,[&]
+  {
+    for(const auto& s: ints)
+      sum+= StringUtils::detail::convert<long,int>(std::string_view(s),strtol,wcstol);
+  }));
+
+  rows.push_back(measure("convert_int",0,argv,argv,minTime,[&]
+  {
+    for(const auto& s: ints)
+      sum+= StringUtils::strToInt(std::string_view(s));
+  }));
+
+  double total= 0;
+  rows.push_back(measure("convert_double",0,argv,argv,minTime,[&]
+  {
+    for(const auto& s: doubles)
+      total+= StringUtils::strToDouble(std::string_view(s));
+  }));
+
+  if(sum==42 && total==42) cout<<""; // keep results alive
+}
+//------------------------------------------------------------------
+void benchHelp(vector<Row>& rows, size_t schema, chrono::nanoseconds minTime)
+{
+  Parser parser;
+  for(size_t i=0; i<schema; ++i)
+  {
+    auto arg= parser.addOptional<int,'+'>("-o"+to_string(i),optionName(i));
+    arg.setHelp("help of option "+to_string(i));
+  }
+  auto sub= parser.addSubParser("cmd");
+  sub->setSubParserHelp("sub command");
+  for(size_t i=0; i<schema/10; ++i)
+    sub->addPositional<string>("p"+to_string(i));
+
+  rows.push_back(measure("help",schema,0,schema,minTime,[&]
+  {
+    if(parser.help(true).empty()) abort();
+  }));
+
+  rows.push_back(measure("usage",schema,0,schema,minTime,[&]
+  {
+    if(parser.usage().empty()) abort();
+  }));
+
+  // not cached, written to a reused string
+  string text;
+  rows.push_back(measure("help_write",schema,0,schema,minTime,[&]
+  {
+    text.clear();
+    parser.writeHelp(back_inserter(text),true);
+    if(text.empty()) abort();
+  }));
+}
+//------------------------------------------------------------------
+void benchExceptions(vector<Row>& rows, size_t schema, size_t argv,
+                     chrono::nanoseconds minTime)
+{
+  Parser parser;
+  for(size_t i=0; i<schema; ++i)
+    parser.addOptional<int>(optionName(i));
+
+  // valid options, then an unknown one
+  vector<string> args;
+  for(size_t i=0; i+1<argv; ++i)
+    args.push_back(optionName(i%schema));
+  args.push_back("--unknown");
+  const Parser::StringViews views(cbegin(args),cend(args));
+
+  ParseResult<char> result;
+  rows.push_back(measure("error_status",schema,argv,argv,minTime,[&]
+  {
+    result.clear();
+    if(parser.tryParseArgs(views,result)) abort();
+  }));
+
+  // the first exception builds the suggestion index of the schema
+  const auto throwOnce= [&]
+  {
+    result.clear();
+    try
+    {
+      parser.parseArgs(views,result);
+      abort();
+    }
+    catch(const ArgParse::UnrecognizedArgumentsException<char>& e)
+    {
+      if(e.what().empty()) abort();
+    }
+  };
+
+  const auto start= Clock::now();
+  throwOnce();
+  const double buildNs= chrono::duration<double,nano>(Clock::now()-start).count();
+  rows.push_back({"error_first",schema,argv,1,buildNs,buildNs/double(argv)});
+
+  rows.push_back(measure("error_exception",schema,argv,argv,minTime,throwOnce));
+}
+//------------------------------------------------------------------
+void benchSuggest(vector<Row>& rows, size_t schema, chrono::nanoseconds minTime)
+{
+  vector<string> names;
+  for(size_t i=0; i<schema; ++i)
+    names.push_back(optionName(i));
+
+  ArgParse::detail::BkTree<char> tree;
+  for(const auto& name: names)
+    tree.insert(name);
+
+  // a typo of an option in the middle of the schema
+  string typo= optionName(schema/2);
+  swap(typo[2],typo[3]);
+
+  rows.push_back(measure("suggest_bktree",schema,1,1,minTime,[&]
+  {
+    if(tree.find(typo,2,3).empty()) abort();
+  }));
+
+  // edit distance to every option string
+  vector<size_t> row;
+  rows.push_back(measure("suggest_sweep",schema,1,1,minTime,[&]
+  {
+    size_t best= size_t(-1);
+    for(const auto& name: names)
+      best= min(best,ArgParse::detail::editDistance<char>(typo,name,row));
+    if(best>2) abort();
+  }));
+}
+//------------------------------------------------------------------
+void writeCsv(const vector<Row>& rows)
+{
+  cout<<"phase,schema,argv,iterations,ns_per_op,ns_per_item\n";
+  cout<<fixed<<setprecision(2);
+  for(const auto& r: rows)
+    cout<<r.phase<<','<<r.schema<<','<<r.argv<<','<<r.iterations<<','
+        <<r.nsPerOp<<','<<r.nsPerItem<<'\n';
+}
+//------------------------------------------------------------------
+void writeJson(const vector<Row>& rows)
+{
+  cout<<"[\n"<<fixed<<setprecision(2);
+  for(size_t i=0; i<rows.size(); ++i)
+  {
+    const auto& r= rows[i];
+    cout<<"  {\"phase\": \""<<r.phase<<"\", "
+        <<"\"schema\": "<<r.schema<<", "
+        <<"\"argv\": "<<r.argv<<", "
+        <<"\"iterations\": "<<r.iterations<<", "
+        <<"\"ns_per_op\": "<<r.nsPerOp<<", "
+        <<"\"ns_per_item\": "<<r.nsPerItem<<"}"
+        <<(i+1<rows.size() ? ",\n" : "\n");
+  }
+  cout<<"]\n";
+}
+//------------------------------------------------------------------
+}
+//------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  Parser parser("-");
+  auto format = parser.addOptional<string>("-f","--format");
+  auto schemas= parser.addOptional<size_t,'+'>("-s","--schema");
+  auto argvs  = parser.addOptional<size_t,'+'>("-a","--argv");
+  auto minTime= parser.addOptional<unsigned>("-t","--min-time");
+  format.setHelp("csv (default) or json");
+  schemas.setHelp("args counts of the parser");
+  argvs.setHelp("tokens counts of the input");
+  minTime.setHelp("milliseconds per measure, 20 by default");
+
+  try
+  {
+    parser.parseArgs(argc-1,argv+1);
+  }
+  catch(const ArgParse::Exception<char>& e)
+  {
+    cerr<<e.what()<<"\nusage: "<<parser.usage()<<'\n'<<parser.help();
+    return 1;
+  }
+
+  const vector<size_t> schemaSizes=
+      schemas ? *schemas : vector<size_t>{10,100,1000};
+  const vector<size_t> argvSizes=
+      argvs ? *argvs : vector<size_t>{16,256,4096};
+  const chrono::nanoseconds time= chrono::milliseconds(minTime ? *minTime : 20);
+
+  vector<Row> rows;
+  for(size_t a: argvSizes)
+  {
+    benchSplit(rows,a,time);
+    benchConvert(rows,a,time);
+  }
+  for(size_t s: schemaSizes)
+  {
+    benchHelp(rows,s,time);
+    benchReset(rows,s,time);
+    benchSuggest(rows,s,time);
+    benchPositionalScaling(rows,s,time);
+    for(size_t a: argvSizes)
+    {
+      benchLookup(rows,s,a,time);
+      benchAbbrev(rows,s,a,time);
+      benchPositional(rows,s,a,time);
+      benchExceptions(rows,s,a,time);
+    }
+  }
+
+  if(format && *format=="json")
+    writeJson(rows);
+  else
+    writeCsv(rows);
+  return 0;
+}
+//------------------------------------------------------------------
@@ -0,0 +1,75 @@
+#include <atomic>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <iostream>
+#include <iomanip>
+//------------------------------------------------------------------
+#include "../../ArgParse/BatchParser.h"
+//------------------------------------------------------------------
+// Throughput of BatchParser::forEach() depending on the threads count,
+// one result per thread whatever the lines count.
+// Expected: near linear speedup up to the cores count.
+//------------------------------------------------------------------
+int main()
+{
+  using namespace std;
+  using Clock= chrono::steady_clock;
+
+  const size_t lineCount= 200000;
+  const size_t repeatCount= 5;
+
+  ArgParse::ArgumentParser<char> parser;
+  auto files= parser.addPositional<string,'+'>("files");
+  auto level= parser.addOptional<int>("-l","--level");
+  auto tags = parser.addOptional<string,'*'>("-t","--tag");
+  auto copy = parser.addSubParser("copy");
+  auto dest = copy->addOptional<string>("-d","--dest");
+  level.setRange(0,9);
+
+  vector<string> lines;
+  lines.reserve(lineCount);
+  for(size_t i=0; i<lineCount; ++i)
+  {
+    lines.push_back("a"+to_string(i)+".txt \"b "+to_string(i)+".txt\""
+                    " --level "+to_string(i%10)+
+                    " -t x y z copy --dest out/"+to_string(i));
+  }
+  const vector<string_view> views(cbegin(lines),cend(lines));
+
+  const size_t cores= max(1u,thread::hardware_concurrency());
+  cout<<"cores: "<<cores<<endl;
+  cout<<setw(10)<<"threads"<<setw(16)<<"lines/s"<<setw(12)<<"speedup"<<endl;
+
+  double base= 0;
+  for(size_t threadCount=1; threadCount<=2*cores; threadCount*=2)
+  {
+    ArgParse::BatchParser<char> batch(parser,threadCount);
+    atomic<size_t> failed{0};
+
+    const auto start= Clock::now();
+    for(size_t r=0; r<repeatCount; ++r)
+    {
+      batch.forEach(views,[&](size_t, const ArgParse::BatchEntry<char>& entry)
+      {
+        if(!entry.ok())
+          ++failed;
+      });
+    }
+    const auto elapsed= Clock::now()-start;
+    if(failed!=0)
+      return 1;
+
+    const double rate=
+      double(repeatCount*lineCount)/chrono::duration<double>(elapsed).count();
+    if(threadCount==1)
+      base= rate;
+
+    cout<<setw(10)<<threadCount
+        <<setw(16)<<fixed<<setprecision(0)<<rate
+        <<setw(12)<<setprecision(2)<<rate/base<<endl;
+  }
+  return 0;
+}
+//------------------------------------------------------------------
@@ -0,0 +1,78 @@
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+//------------------------------------------------------------------
+#include "../../ArgParse/StringUtils.h"
+//------------------------------------------------------------------
+// Per value cost of numeric conversion:
+//   strto   - detail::convert, std::strtol/std::strtod and errno
+//   from_chars - detail::convertFromChars, used by strToXxx<char>
+//------------------------------------------------------------------
+template<typename F>
+double measure(const std::vector<std::string>& values, F f)
+{
+  using Clock= std::chrono::steady_clock;
+
+  const std::size_t repeatCount= 50;
+  const auto start= Clock::now();
+  for(std::size_t r=0; r<repeatCount; ++r)
+    for(const auto& value: values)
+      f(std::string_view(value));
+  const auto elapsed= Clock::now()-start;
+
+  return std::chrono::duration<double,std::nano>(elapsed).count()/
+         double(repeatCount*values.size());
+}
+//------------------------------------------------------------------
+template<typename T, typename Strto, typename Fc>
+void compare(const char* type,
+             const std::vector<std::string>& values,
+             Strto strto, Fc fc)
+{
+  using namespace std;
+
+  volatile T sink{};
+  const double nsStrto= measure(values,[&](auto s){ sink= sink+strto(s); });
+  const double nsFc   = measure(values,[&](auto s){ sink= sink+fc(s);    });
+
+  cout<<setw(12)<<type
+      <<setw(12)<<fixed<<setprecision(1)<<nsStrto
+      <<setw(14)<<nsFc
+      <<setw(10)<<setprecision(2)<<nsStrto/nsFc<<"x"<<endl;
+}
+//------------------------------------------------------------------
+int main()
+{
+  using namespace std;
+  using namespace StringUtils::detail;
+
+  vector<string> ints, longLongs, doubles;
+  for(int i=0; i<10000; ++i)
+  {
+    ints.push_back(to_string((i*7919)%2000000-1000000));
+    longLongs.push_back(to_string((i*7919LL)*1000003LL));
+    doubles.push_back(to_string(i*0.37-1000.0)+"e-3");
+  }
+
+  cout<<setw(12)<<"type"<<setw(12)<<"strto ns"
+      <<setw(14)<<"from_chars ns"<<setw(11)<<"speedup"<<endl;
+
+  compare<int>("int",ints,
+    [](auto s){ return convert<long,int>(s,strtol,wcstol); },
+    [](auto s){ return convertFromChars<int>(s); });
+
+  compare<long long>("long long",longLongs,
+    [](auto s){ return convert<long long>(s,strtoll,wcstoll); },
+    [](auto s){ return convertFromChars<long long>(s); });
+
+  if constexpr(hasFloatFromChars)
+  {
+    compare<double>("double",doubles,
+      [](auto s){ return convert<double>(s,strtod,wcstod); },
+      [](auto s){ return convertFromChars<double>(s); });
+  }
+  return 0;
+}
+//------------------------------------------------------------------
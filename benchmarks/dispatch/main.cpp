@@ -0,0 +1,88 @@
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+//------------------------------------------------------------------
+#include "../../ArgParse/ArgumentParser.h"
+#include "../../tests/common/ArgConversion.h"
+//------------------------------------------------------------------
+// Per value cost of the conversion of 1000 mixed type optionals,
+// each given one value: through ArgRecord::convert as the parse does,
+// through the virtual ArgInfo::assingOrAppendFromString, and by the
+// whole parse for reference.
+//------------------------------------------------------------------
+int main()
+{
+  using namespace std;
+  using Clock= chrono::steady_clock;
+  using Parser= ArgParse::ArgumentParser<char>;
+  using Conversion= ArgParse::detail::ArgConversion<char>;
+
+  const size_t argCount= 1000;
+
+  Parser parser("-");
+  vector<string> args;
+  for(size_t i=0; i<argCount; ++i)
+  {
+    const string option= "--a"+to_string(i);
+    args.push_back(option);
+    switch(i%6)
+    {
+      case 0: parser.addOptional<int>(option);         args.push_back(to_string(i));       break;
+      case 1: parser.addOptional<unsigned>(option);    args.push_back(to_string(i*7));     break;
+      case 2: parser.addOptional<long long>(option);   args.push_back(to_string(i*1000003)); break;
+      case 3: parser.addOptional<double>(option);      args.push_back(to_string(i*0.25));  break;
+      case 4: parser.addOptional<float>(option);       args.push_back(to_string(i*0.5));   break;
+      case 5: parser.addOptional<string>(option);      args.push_back("s"+to_string(i));   break;
+    }
+  }
+  const Parser::StringViews views(cbegin(args),cend(args));
+
+  ArgParse::ParseResult<char> result;
+  const size_t repeatCount= 500;
+
+  // best of 5 runs, ns per arg
+  const auto measure= [&](const auto& f)
+  {
+    double best= 1e300;
+    for(size_t r=0; r<5; ++r)
+    {
+      const auto start= Clock::now();
+      for(size_t k=0; k<repeatCount; ++k)
+      {
+        result.clear();
+        if(!f())
+          exit(1);
+      }
+      const auto elapsed= Clock::now()-start;
+      best= min(best,chrono::duration<double,nano>(elapsed).count()/
+                     double(repeatCount*argCount));
+    }
+    return best;
+  };
+
+  const auto convertAll= [&](auto convert)
+  {
+    return [&parser,&views,&result,convert]
+    {
+      const auto& optionals= parser.optionals();
+      for(size_t i=0; i<optionals.size(); ++i)
+        if(convert(*optionals[i],views[2*i+1],result)!=ArgParse::ErrorCode::none)
+          return false;
+      return true;
+    };
+  };
+
+  const double byRecord = measure(convertAll(&Conversion::byRecord));
+  const double byVirtual= measure(convertAll(&Conversion::byVirtual));
+  const double parse    = measure([&]{ return bool(parser.tryParseArgs(views,result)); });
+
+  cout<<fixed<<setprecision(2)
+      <<"table:   "<<byRecord <<" ns per arg\n"
+      <<"virtual: "<<byVirtual<<" ns per arg\n"
+      <<"parse:   "<<parse    <<" ns per arg\n";
+  return 0;
+}
+//------------------------------------------------------------------
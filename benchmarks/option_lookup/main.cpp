@@ -0,0 +1,50 @@
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+//------------------------------------------------------------------
+#include "../../ArgParse/ArgumentParser.h"
+//------------------------------------------------------------------
+// Cost of one option token lookup depending on the options count.
+// Expected: ns/lookup stays flat while the options count grows.
+//------------------------------------------------------------------
+int main()
+{
+  using namespace std;
+  using Clock= chrono::steady_clock;
+
+  const size_t lookupCount= 4096;
+  const size_t repeatCount= 20;
+
+  cout<<setw(10)<<"options"<<setw(16)<<"ns/lookup"<<endl;
+
+  for(size_t optionCount: {10u, 100u, 1000u, 10000u})
+  {
+    ArgParse::ArgumentParser<char> parser;
+    for(size_t i=0; i<optionCount; ++i)
+      parser.addOptional<int>("-o"+to_string(i),"--option"+to_string(i));
+
+    // options spread over the whole schema, last ones are the worst case
+    // for a linear scan
+    vector<string> args;
+    for(size_t i=0; i<lookupCount; ++i)
+    {
+      const size_t n= optionCount-1-(i*optionCount/lookupCount);
+      args.push_back("--option"+to_string(n));
+    }
+
+    const auto start= Clock::now();
+    for(size_t r=0; r<repeatCount; ++r)
+      parser.parseArgs(args);
+    const auto elapsed= Clock::now()-start;
+
+    const double ns=
+      chrono::duration<double,nano>(elapsed).count()/
+      double(repeatCount*lookupCount);
+
+    cout<<setw(10)<<optionCount<<setw(16)<<fixed<<setprecision(1)<<ns<<endl;
+  }
+  return 0;
+}
+//------------------------------------------------------------------
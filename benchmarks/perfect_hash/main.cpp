@@ -0,0 +1,131 @@
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <unordered_map>
+//------------------------------------------------------------------
+#include "../../ArgParse/PerfectHash.h"
+//------------------------------------------------------------------
+// Cost of one option string lookup: linear scan, binary search,
+// the hash map of ArgumentParser and the perfect hash of StaticParser.
+// Lookups alternate known options and unknown tokens.
+//------------------------------------------------------------------
+namespace
+{
+//------------------------------------------------------------------
+using namespace std;
+using Clock= chrono::steady_clock;
+//------------------------------------------------------------------
+template<typename F>
+double measure(const vector<string_view>& tokens, F find)
+{
+  const size_t repeatCount= 200;
+
+  size_t sum= 0;
+  double best= 1e300;
+  for(int run=0; run<3; ++run)
+  {
+    const auto start= Clock::now();
+    for(size_t r=0; r<repeatCount; ++r)
+      for(string_view token: tokens)
+        sum+= find(token);
+    const auto elapsed= Clock::now()-start;
+    best= min(best,chrono::duration<double,nano>(elapsed).count()/
+                   double(repeatCount*tokens.size()));
+  }
+  if(sum==42) cout<<"";
+  return best;
+}
+//------------------------------------------------------------------
+template<size_t n>
+void bench()
+{
+  const size_t npos= size_t(-1);
+  const size_t lookupCount= 4096;
+
+  vector<string> names;
+  for(size_t i=0; i<n; ++i)
+    names.push_back(i%2 ? "--option"+to_string(i) : "-o"+to_string(i));
+
+  vector<string> tokenStrings;
+  for(size_t i=0; i<lookupCount; ++i)
+    tokenStrings.push_back(i%2 ? names[(i*7919)%n] : "--unknown"+to_string(i));
+  const vector<string_view> tokens(tokenStrings.begin(),tokenStrings.end());
+
+  // linear
+  const vector<string_view> linear(names.begin(),names.end());
+
+  // binary search
+  vector<pair<string_view,size_t>> sorted;
+  for(size_t i=0; i<n; ++i)
+    sorted.emplace_back(names[i],i);
+  sort(sorted.begin(),sorted.end());
+
+  // hash map
+  unordered_map<string_view,size_t> map;
+  for(size_t i=0; i<n; ++i)
+    map.emplace(names[i],i);
+
+  // perfect hash, built at compile time by StaticParser
+  array<uint64_t,n> hashes;
+  for(size_t i=0; i<n; ++i)
+    hashes[i]= ArgParse::detail::hashString(string_view(names[i]));
+  const auto hash= ArgParse::detail::PerfectHash<n>::build(hashes);
+  if(!hash.ok()) abort();
+  array<pair<string_view,size_t>,n> table;
+  for(size_t i=0; i<n; ++i)
+    table[hash.slot(hashes[i])]= {names[i],i};
+
+  const double linearNs= measure(tokens,[&](string_view s)
+  {
+    const auto it= find(linear.begin(),linear.end(),s);
+    return it==linear.end() ? npos : size_t(it-linear.begin());
+  });
+
+  const double binaryNs= measure(tokens,[&](string_view s)
+  {
+    const auto it= lower_bound(sorted.begin(),sorted.end(),s,
+                               [](const auto& e, string_view s){ return e.first<s; });
+    return it!=sorted.end() && it->first==s ? it->second : npos;
+  });
+
+  const double mapNs= measure(tokens,[&](string_view s)
+  {
+    const auto it= map.find(s);
+    return it==map.end() ? npos : it->second;
+  });
+
+  const double perfectNs= measure(tokens,[&](string_view s)
+  {
+    const auto& e= table[hash.slot(ArgParse::detail::hashString(s))];
+    return e.first==s ? e.second : npos;
+  });
+
+  cout<<fixed<<setprecision(1)
+      <<setw(10)<<n
+      <<setw(12)<<linearNs
+      <<setw(12)<<binaryNs
+      <<setw(12)<<mapNs
+      <<setw(12)<<perfectNs<<endl;
+}
+//------------------------------------------------------------------
+}
+//------------------------------------------------------------------
+int main()
+{
+  cout<<setw(10)<<"options"
+      <<setw(12)<<"linear ns"
+      <<setw(12)<<"binary ns"
+      <<setw(12)<<"map ns"
+      <<setw(12)<<"perfect ns"<<endl;
+
+  bench<8>();
+  bench<64>();
+  bench<512>();
+  bench<4096>();
+  return 0;
+}
+//------------------------------------------------------------------
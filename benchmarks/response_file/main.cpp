@@ -0,0 +1,80 @@
+#include <string>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <filesystem>
+//------------------------------------------------------------------
+#include "../../ArgParse/ResponseFiles.h"
+//------------------------------------------------------------------
+// Expansion of a 100 MB response file of paths: memory mapped views
+// against reading the file to a string and copying tokens by split().
+//------------------------------------------------------------------
+int main()
+{
+  using namespace std;
+  using Clock= chrono::steady_clock;
+  namespace fs= std::filesystem;
+
+  const size_t fileSize= 100*1024*1024;
+  const fs::path path= fs::temp_directory_path()/"argparse_bench.rsp";
+  {
+    ofstream file(path,ios::binary);
+    size_t size= 0;
+    for(size_t i=0; size<fileSize; ++i)
+    {
+      const string line= (i%16==0)
+        ? "\"/data/set "+to_string(i%97)+"/file_"+to_string(i)+".bin\"\n"
+        : "/data/set_"+to_string(i%97)+"/file_"+to_string(i)+".bin\n";
+      file<<line;
+      size+= line.size();
+    }
+  }
+  const string arg= "@"+path.string();
+  const double mb= double(fs::file_size(path))/(1024*1024);
+
+  const auto report= [&](const char* name, Clock::duration elapsed, size_t count)
+  {
+    const double s= chrono::duration<double>(elapsed).count();
+    cout<<setw(24)<<name
+        <<setw(12)<<count
+        <<setw(12)<<fixed<<setprecision(1)<<s*1000
+        <<setw(12)<<mb/s<<endl;
+  };
+
+  cout<<setw(24)<<"method"<<setw(12)<<"tokens"
+      <<setw(12)<<"ms"<<setw(12)<<"MB/s"<<endl;
+
+  // copy: read to string, split() to strings
+  {
+    const auto start= Clock::now();
+    ifstream file(path,ios::binary);
+    stringstream buffer;
+    buffer<<file.rdbuf();
+    const auto tokens= StringUtils::split(buffer.str());
+    report("read + split",Clock::now()-start,tokens.size());
+  }
+
+  ArgParse::ResponseFiles files;
+  for(int i=0; i<2; ++i) // second run with warm page cache and buffers
+  {
+    const auto start= Clock::now();
+    const auto& tokens= files.expand({arg});
+    report("mmap + views",Clock::now()-start,tokens.size());
+  }
+
+  {
+    ArgParse::ArgumentParser<char> parser("-"); // paths start with '/'
+    auto paths= parser.addPositional<string,'*'>("paths");
+
+    const auto start= Clock::now();
+    parser.parseArgs(files.expand({arg}));
+    report("mmap + parse",Clock::now()-start,paths.values().size());
+  }
+
+  fs::remove(path);
+  return 0;
+}
+//------------------------------------------------------------------
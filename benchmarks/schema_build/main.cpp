@@ -0,0 +1,99 @@
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <memory_resource>
+//------------------------------------------------------------------
+#include "../../ArgParse/ArgumentParser.h"
+//------------------------------------------------------------------
+// Cost of building and destroying a schema, default heap against
+// a monotonic arena reused between iterations.
+//------------------------------------------------------------------
+namespace
+{
+//------------------------------------------------------------------
+using namespace std;
+using Clock= chrono::steady_clock;
+//------------------------------------------------------------------
+// option strings are made in advance, only the schema is measured
+struct Names
+{
+  explicit Names(size_t optionCount)
+  {
+    for(size_t i=0; i<optionCount; ++i)
+    {
+      shortNames.push_back("-o"+to_string(i));
+      longNames.push_back("--option"+to_string(i));
+    }
+  }
+
+  vector<string> shortNames;
+  vector<string> longNames;
+};
+//------------------------------------------------------------------
+// 10 sub parsers, options are split between the root and sub parsers
+void build(ArgParse::ArgumentParser<char>& parser,const Names& names)
+{
+  const size_t optionCount= names.shortNames.size();
+  const size_t perParser= optionCount/11;
+
+  ArgParse::ArgumentParser<char>* current= &parser;
+  vector<ArgParse::ArgumentParser<char>::ArgumentParserPtr> subParsers;
+  for(size_t i=0; i<optionCount; ++i)
+  {
+    if(perParser!=0 && i!=0 && i%perParser==0 && subParsers.size()<10)
+    {
+      subParsers.push_back(parser.addSubParser("cmd"+to_string(i)));
+      current= subParsers.back().get();
+    }
+    current->addOptional<int>(names.shortNames[i],names.longNames[i]);
+  }
+}
+//------------------------------------------------------------------
+}
+//------------------------------------------------------------------
+int main()
+{
+  const size_t repeatCount= 50;
+
+  cout<<setw(10)<<"options"
+      <<setw(16)<<"heap us"
+      <<setw(16)<<"arena us"<<endl;
+
+  for(size_t optionCount: {10u, 100u, 1000u, 10000u})
+  {
+    const Names names(optionCount);
+
+    auto start= Clock::now();
+    for(size_t r=0; r<repeatCount; ++r)
+    {
+      ArgParse::ArgumentParser<char> parser;
+      build(parser,names);
+    }
+    const auto heap= Clock::now()-start;
+
+    pmr::monotonic_buffer_resource arena;
+    start= Clock::now();
+    for(size_t r=0; r<repeatCount; ++r)
+    {
+      {
+        ArgParse::ArgumentParser<char> parser(&arena);
+        build(parser,names);
+      }
+      arena.release();
+    }
+    const auto arenaTime= Clock::now()-start;
+
+    const auto us= [=](Clock::duration d)
+    {
+      return chrono::duration<double,micro>(d).count()/double(repeatCount);
+    };
+
+    cout<<setw(10)<<optionCount
+        <<setw(16)<<fixed<<setprecision(1)<<us(heap)
+        <<setw(16)<<us(arenaTime)<<endl;
+  }
+  return 0;
+}
+//------------------------------------------------------------------
@@ -0,0 +1,127 @@
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <functional>
+//------------------------------------------------------------------
+#include "../../ArgParse/StringUtils.h"
+//------------------------------------------------------------------
+// Tokenizing of long command lines:
+//   legacy  - char by char split with a copy per char (previous split)
+//   split   - StringUtils::SplitBuffer, best scanner for this CPU
+//   scalar/sse2/avx2 - raw whitespace/quote scanner over the input
+//------------------------------------------------------------------
+std::vector<std::string> legacySplit(const std::string& str)
+{
+  using namespace std;
+  vector<string> result;
+  string current;
+  bool quoted= false;
+
+  auto first=
+    find_if_not(cbegin(str),cend(str),[](auto c){return isspace(c);});
+  while(true)
+  {
+    if(first==cend(str))
+    {
+      if(!current.empty())
+        result.push_back(current);
+      return result;
+    }
+    else if(!quoted && isspace(*first))
+    {
+      result.push_back(current);
+      current.clear();
+      first= find_if_not(first, cend(str),[](auto c){return isspace(c);});
+      continue;
+    }
+    else
+    {
+      if(StringUtils::isQuote(*first))
+        quoted= !quoted;
+      else
+        current+= *first;
+      ++first;
+    }
+  }
+}
+//------------------------------------------------------------------
+std::string makeCmdLine(std::size_t size)
+{
+  // value lists: file paths, numbers and some quoted values
+  std::string str;
+  for(std::size_t i=0; str.size()<size; ++i)
+  {
+    if(i%16==0)
+      str+= "\"quoted value "+std::to_string(i)+"\" ";
+    else if(i%2==0)
+      str+= "/usr/local/share/argparse/data/file_"+std::to_string(i)+".txt ";
+    else
+      str+= std::to_string(i*7919)+" ";
+  }
+  str.resize(size);
+  return str;
+}
+//------------------------------------------------------------------
+template<typename F>
+double measure(std::size_t bytes, F f)
+{
+  using Clock= std::chrono::steady_clock;
+
+  const std::size_t repeatCount= std::max<std::size_t>(1,(64u<<20)/bytes);
+  const auto start= Clock::now();
+  for(std::size_t r=0; r<repeatCount; ++r)
+    f();
+  const auto elapsed= Clock::now()-start;
+
+  const double seconds= std::chrono::duration<double>(elapsed).count();
+  return double(bytes)*repeatCount/seconds/(1<<20); // MB/s
+}
+//------------------------------------------------------------------
+int main()
+{
+  using namespace std;
+  using namespace StringUtils::detail;
+
+  vector<pair<const char*,FindSpaceOrQuoteFunc>> scanners=
+  {
+    {"scalar",&findSpaceOrQuoteScalar}
+  };
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+  if(cpuHasSse2())
+    scanners.push_back({"sse2",&findSpaceOrQuoteSse2});
+  if(cpuHasAvx2())
+    scanners.push_back({"avx2",&findSpaceOrQuoteAvx2});
+#endif
+
+  cout<<setw(10)<<"input"<<setw(12)<<"method"<<setw(14)<<"MB/s"<<endl;
+
+  volatile size_t sink= 0;
+  for(size_t size: {size_t(1)<<10, size_t(64)<<10, size_t(1)<<20})
+  {
+    const string str= makeCmdLine(size);
+    auto print= [size](const char* method,double mbs)
+    {
+      cout<<setw(9)<<(size>>10)<<"K"<<setw(12)<<method
+          <<setw(14)<<fixed<<setprecision(1)<<mbs<<endl;
+    };
+
+    print("legacy",measure(size,[&]{ sink= sink+legacySplit(str).size(); }));
+
+    StringUtils::SplitBuffer<char> buffer;
+    print("split",measure(size,[&]{ sink= sink+buffer.split(str).size(); }));
+
+    for(const auto& [name,scan]: scanners)
+    {
+      print(name,measure(size,[&, scan=scan]
+      {
+        for(size_t pos=0; pos<str.size(); ++pos)
+          pos= scan(str.data(),str.size(),pos);
+        sink= sink+1;
+      }));
+    }
+  }
+  return 0;
+}
+//------------------------------------------------------------------
@@ -0,0 +1,91 @@
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+//------------------------------------------------------------------
+#include "../../ArgParse/StaticParser.h"
+#include "../../tests/common/AllocationCount.h"
+//------------------------------------------------------------------
+// Startup of a typical tool: schema build and one parse,
+// ArgumentParser against StaticParser, with heap allocations count.
+//------------------------------------------------------------------
+namespace
+{
+//------------------------------------------------------------------
+using namespace std;
+using namespace ArgParse;
+using Clock= chrono::steady_clock;
+//------------------------------------------------------------------
+constexpr auto cli= schema::make(
+    schema::positional<string>("input"),
+    schema::positional<string,'?'>("output"),
+    schema::optional<int>("-j","--jobs").help("parallel jobs"),
+    schema::optional<double>("-t","--threshold").required(),
+    schema::optional<string,'+'>("-I","--include"),
+    schema::optional<unsigned>("-v","--verbose"),
+    schema::optional<bool>("-f","--force"),
+    schema::optional<string>("-c","--config"));
+
+const char* argv[]=
+    {"in.txt","out.txt","-j","8","-t","0.25","-I","a","b","c","-v","2","-c","x.cfg"};
+const int argc= int(size(argv));
+//------------------------------------------------------------------
+int runtimeStartup()
+{
+  ArgumentParser<char> parser;
+  parser.addPositional<string>("input");
+  parser.addPositional<string,'?'>("output");
+  auto jobs= parser.addOptional<int>("-j","--jobs");
+  jobs.setHelp("parallel jobs");
+  parser.addOptional<double>("-t","--threshold").setRequired(true);
+  parser.addOptional<string,'+'>("-I","--include");
+  parser.addOptional<unsigned>("-v","--verbose");
+  parser.addOptional<bool>("-f","--force");
+  parser.addOptional<string>("-c","--config");
+
+  if(!parser.tryParseArgs(argc,argv)) abort();
+  return *jobs;
+}
+//------------------------------------------------------------------
+int staticStartup()
+{
+  StaticParser<cli> parser;
+  if(!parser.tryParseArgs(argc,argv)) abort();
+  return *parser.value<2>();
+}
+//------------------------------------------------------------------
+template<typename F>
+void measure(const char* name, F f)
+{
+  const size_t repeatCount= 20000;
+
+  int sum= 0;
+  const size_t before= allocationCount();
+  const auto start= Clock::now();
+  for(size_t r=0; r<repeatCount; ++r)
+    sum+= f();
+  const auto elapsed= Clock::now()-start;
+
+  cout<<setw(10)<<name
+      <<setw(16)<<chrono::duration<double,nano>(elapsed).count()/repeatCount
+      <<setw(16)<<double(allocationCount()-before)/repeatCount
+      <<(sum==42 ? " " : "")<<endl;
+}
+//------------------------------------------------------------------
+}
+//------------------------------------------------------------------
+int main()
+{
+  cout<<setw(10)<<"parser"
+      <<setw(16)<<"ns/startup"
+      <<setw(16)<<"allocations"<<endl;
+
+  for(int i=0; i<3; ++i)
+  {
+    measure("runtime",runtimeStartup);
+    measure("static",staticStartup);
+  }
+  return 0;
+}
+//------------------------------------------------------------------
@@ -4,7 +4,9 @@
 //------------------------------------------------------------------
 #include "../../ArgParse/ArgumentParser.h"
 //------------------------------------------------------------------
-#define OS_WINDOWS
+#ifdef _WIN32
+  #define OS_WINDOWS
+#endif
 
 #ifdef OS_WINDOWS
   #include <Windows.h>
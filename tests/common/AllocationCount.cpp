@@ -0,0 +1,94 @@
+#include "AllocationCount.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+//------------------------------------------------------------------
+// Every form of the global operator new/delete is replaced, so no
+// allocation reaches the library ones and each delete frees memory
+// allocated here. The replacements live in their own translation unit:
+// no caller sees the malloc/free pair behind a new-expression.
+//------------------------------------------------------------------
+namespace
+{
+//------------------------------------------------------------------
+std::atomic<std::size_t> count{0};
+//------------------------------------------------------------------
+void* allocate(std::size_t size, std::size_t alignment) noexcept
+{
+  ++count;
+  if(size==0)
+    size= 1;
+  if(alignment<=alignof(std::max_align_t))
+    return std::malloc(size);
+  // aligned_alloc requires a multiple of the alignment
+  return std::aligned_alloc(alignment,(size+alignment-1)/alignment*alignment);
+}
+//------------------------------------------------------------------
+void* allocateOrThrow(std::size_t size, std::size_t alignment)
+{
+  if(void* p= allocate(size,alignment))
+    return p;
+  throw std::bad_alloc();
+}
+//------------------------------------------------------------------
+} // namespace
+//------------------------------------------------------------------
+std::size_t allocationCount()
+{
+  return count.load();
+}
+//------------------------------------------------------------------
+void* operator new(std::size_t size)
+{
+  return allocateOrThrow(size,alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size)
+{
+  return allocateOrThrow(size,alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t al)
+{
+  return allocateOrThrow(size,static_cast<std::size_t>(al));
+}
+
+void* operator new[](std::size_t size, std::align_val_t al)
+{
+  return allocateOrThrow(size,static_cast<std::size_t>(al));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  return allocate(size,alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+  return allocate(size,alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept
+{
+  return allocate(size,static_cast<std::size_t>(al));
+}
+
+void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept
+{
+  return allocate(size,static_cast<std::size_t>(al));
+}
+//------------------------------------------------------------------
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+//------------------------------------------------------------------
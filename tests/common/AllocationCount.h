@@ -0,0 +1,11 @@
+#ifndef ALLOCATIONCOUNT_H
+#define ALLOCATIONCOUNT_H
+
+#include <cstddef>
+//------------------------------------------------------------------
+// Number of global operator new calls since the program start,
+// counted by the replacements in AllocationCount.cpp.
+//------------------------------------------------------------------
+std::size_t allocationCount();
+//------------------------------------------------------------------
+#endif // ALLOCATIONCOUNT_H
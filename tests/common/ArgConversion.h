@@ -0,0 +1,35 @@
+#ifndef ARGCONVERSION_H
+#define ARGCONVERSION_H
+
+#include "../../ArgParse/ArgumentParser.h"
+//------------------------------------------------------------------
+namespace ArgParse
+{
+namespace detail
+{
+//------------------------------------------------------------------
+// Both conversion paths of an arg: the ArgRecord::convert function
+// used by the parse and the virtual ArgInfo::assingOrAppendFromString.
+//------------------------------------------------------------------
+template<typename CharT>
+struct ArgConversion
+{
+  using StringView= std::basic_string_view<CharT>;
+
+  static ErrorCode byRecord(const ArgInfo<CharT>& arg, StringView str,
+                            ParseResult<CharT>& result)
+  {
+    return arg.tree_->args[arg.slot_].convert(arg,str,result);
+  }
+
+  static ErrorCode byVirtual(const ArgInfo<CharT>& arg, StringView str,
+                             ParseResult<CharT>& result)
+  {
+    return arg.assingOrAppendFromString(str,result);
+  }
+};
+//------------------------------------------------------------------
+} // end namespace detail
+} // end namespace ArgParse
+//------------------------------------------------------------------
+#endif // ARGCONVERSION_H
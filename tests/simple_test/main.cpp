@@ -1,10 +1,25 @@
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <iostream>
 #include <vector>
 #include <string>
+#include <chrono>
+#include <thread>
+#include <memory_resource>
+#include <sstream>
+#include <cstdio>
+#include <fstream>
+#include <filesystem>
 
 #include "../../ArgParse/ArgumentParser.h"
+#include "../../ArgParse/BatchParser.h"
+#include "../../ArgParse/CmdLineReader.h"
+#include "../../ArgParse/ResponseFiles.h"
+#include "../../ArgParse/StaticParser.h"
+
+#include "../common/AllocationCount.h"
+#include "../common/ArgConversion.h"
 
 using namespace ArgParse;
 using namespace std::literals;
@@ -72,16 +87,48 @@ TEST(StringUtils, strToLong)
   ASSERT_THROW(strToLong<char>("abc"),   std::invalid_argument);
   ASSERT_THROW(strToLong<char>("10abc"), std::invalid_argument);
 
-  ASSERT_LT(sizeof(long),sizeof(long long));
-
-  const long long maxLong = std::numeric_limits<long>::max();
-  const long long lowestLong= std::numeric_limits<long>::lowest();
+  // sizeof(long) may be equal to sizeof(long long) (LP64),
+  // so overflow via an extra digit instead of long long arithmetic
+  const std::string maxLong = std::to_string(std::numeric_limits<long>::max());
+  const std::string lowestLong= std::to_string(std::numeric_limits<long>::lowest());
 
-  ASSERT_THROW(strToLong<char>(std::to_string(maxLong+1)),std::out_of_range);
-  ASSERT_THROW(strToLong<char>(std::to_string(lowestLong-1)),std::out_of_range);
+  ASSERT_THROW(strToLong<char>(maxLong+"0"),std::out_of_range);
+  ASSERT_THROW(strToLong<char>(lowestLong+"0"),std::out_of_range);
 }
 
 
+TEST(StringUtils, fromChars)
+{
+  using namespace StringUtils;
+
+  ASSERT_EQ(strToInt<char>("+10"), 10);
+  ASSERT_THROW(strToInt<char>("+-10"),  std::invalid_argument);
+  ASSERT_THROW(strToInt<char>(""),      std::invalid_argument);
+  ASSERT_THROW(strToInt<char>("1 "),    std::invalid_argument);
+
+  ASSERT_EQ(strToULongLong<char>("18446744073709551615"),
+            std::numeric_limits<unsigned long long>::max());
+  ASSERT_THROW(strToULongLong<char>("18446744073709551616"), std::out_of_range);
+  ASSERT_THROW(strToULongLong<char>("-1"),   std::out_of_range);
+  ASSERT_THROW(strToULongLong<char>("-abc"), std::invalid_argument);
+
+  ASSERT_EQ(strToLongLong<char>("-9223372036854775808"),
+            std::numeric_limits<long long>::lowest());
+
+  ASSERT_DOUBLE_EQ(strToDouble<char>("-7.6e-8"), -7.6e-8);
+  ASSERT_DOUBLE_EQ(strToDouble<char>("+2.5"), 2.5);
+  ASSERT_FLOAT_EQ(strToFloat<char>("3.25"), 3.25f);
+  ASSERT_THROW(strToDouble<char>("1e400"), std::out_of_range);
+  ASSERT_THROW(strToFloat<char>("1e40"),   std::out_of_range);
+  ASSERT_THROW(strToDouble<char>("3.5x"),  std::invalid_argument);
+  ASSERT_THROW(strToDouble<char>("."),     std::invalid_argument);
+
+  // wchar_t keeps the wcstol/wcstod path with the same semantics
+  ASSERT_EQ(strToInt<wchar_t>(L"-10"), -10);
+  ASSERT_THROW(strToInt<wchar_t>(L"10abc"), std::invalid_argument);
+  ASSERT_THROW(strToUInt<wchar_t>(L"-10"),  std::out_of_range);
+}
+
 TEST(split_cmd_line, test_quote)
 {
   auto args = split(R"(1 2 "31 32 33" 4 "5"6" 7" 8)"s);
@@ -94,6 +141,78 @@ TEST(split_cmd_line, test_quote)
   ASSERT_EQ(args[5],"8"s);
 }
 
+TEST(split_cmd_line, test_views)
+{
+  const std::string str= R"(1 2 "31 32 33" 4 "5"6" 7" 8 "")";
+  StringUtils::SplitBuffer<char> buffer;
+
+  const auto& args = buffer.split(str);
+  ASSERT_EQ(args.size(), 6) << "split result size must be 6";
+  ASSERT_EQ(args[2],"31 32 33"sv);
+  ASSERT_EQ(args[4],"56 7"sv);
+
+  const auto inStr= [&str](std::string_view token)
+  {
+    return token.data()>=str.data() && token.data()<str.data()+str.size();
+  };
+  ASSERT_TRUE(inStr(args[0])) << "unquoted token is not copied";
+  ASSERT_TRUE(inStr(args[5]));
+  ASSERT_FALSE(inStr(args[2])) << "quoted token is unquoted into scratch";
+
+  ASSERT_EQ(buffer.split(" a  b ").size(),2);
+  ASSERT_TRUE(buffer.split("   ").empty());
+
+  ArgumentParser parser;
+  auto p1 = parser.addPositional<std::string,'+'>("p1");
+  auto o1 = parser.addOptional<int,'+'>("-o");
+  ASSERT_NO_THROW(parser.parseCmdLine("a \"b c\" -o 1 2"sv,buffer));
+  ASSERT_EQ(*p1,(std::vector<std::string>{"a","b c"}));
+  ASSERT_EQ(*o1,(std::vector<int>{1,2}));
+}
+
+TEST(split_cmd_line, test_scan)
+{
+  using namespace StringUtils::detail;
+
+  // every position of every kind of stop char, chunk borders included
+  const std::string stops= " \t\n\v\f\r\"";
+  for(std::size_t length: {1u,15u,16u,17u,31u,32u,33u,70u})
+  {
+    for(std::size_t pos=0; pos<length; ++pos)
+    {
+      for(char stop: stops)
+      {
+        std::string str(length,'x');
+        str[0]= '\x08';              // '\t'-1, not a space
+        str[length-1]= char(0xA0);  // negative char, not a space
+        str[pos]= stop;
+
+        const std::size_t expected= findSpaceOrQuoteScalar(str.data(),length,0);
+        ASSERT_EQ(expected,pos);
+        ASSERT_EQ(findSpaceOrQuote(str.data(),length,0),expected);
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+        ASSERT_EQ(findSpaceOrQuoteSse2(str.data(),length,0),expected);
+        if(cpuHasAvx2())
+        {
+          ASSERT_EQ(findSpaceOrQuoteAvx2(str.data(),length,0),expected);
+        }
+#endif
+      }
+    }
+  }
+
+  const std::string noStop(100,'x');
+  ASSERT_EQ(findSpaceOrQuote(noStop.data(),noStop.size(),3),noStop.size());
+
+  std::string longArgs;
+  for(int i=0; i<100; ++i)
+    longArgs+= "value"+std::to_string(i)+"\t\"quoted "+std::to_string(i)+"\" ";
+  const auto args= split(longArgs);
+  ASSERT_EQ(args.size(),200);
+  ASSERT_EQ(args[198],"value99");
+  ASSERT_EQ(args[199],"quoted 99");
+}
+
 TEST(common,LatinView)
 {
   using namespace StringUtils::literals;
@@ -173,6 +292,758 @@ TEST(common,Exceptions)
   // Invalid chose
 }
 
+TEST(common,tryParse)
+{
+  ArgumentParser parser;
+  auto p1 = parser.addPositional<int,1,2>("p1");
+  auto o1 = parser.addOptional<int>("-o");
+  auto o2 = parser.addOptional<std::string>("-s");
+  o2.setMaxLength(2);
+  auto cmd = parser.addSubParser("cmd");
+  auto r1 = cmd->addOptional<int>("-r");
+  r1.setRequired(true);
+
+  StringUtils::SplitBuffer<char> buffer;
+  const auto& tokens= buffer.tokens();
+
+  auto status= parser.tryParseCmdLine("1 -o 2 cmd -r 3",buffer);
+  ASSERT_TRUE(status.ok());
+  ASSERT_EQ(*r1,3);
+  parser.reset();
+
+  status= parser.tryParseCmdLine("1 2 3",buffer);
+  ASSERT_EQ(status.error,ErrorCode::unrecognizedArguments);
+  ASSERT_EQ(status.index,2);
+  ASSERT_EQ(status.count,1);
+  parser.reset();
+
+  status= parser.tryParseCmdLine("1 -o x",buffer);
+  ASSERT_EQ(status.error,ErrorCode::invalidArgument);
+  ASSERT_EQ(tokens[status.index],"x");
+  ASSERT_EQ(status.arg,o1.info().get());
+  parser.reset();
+
+  status= parser.tryParseCmdLine("1 -o 99999999999",buffer);
+  ASSERT_EQ(status.error,ErrorCode::outOfRange);
+  ASSERT_EQ(status.index,2);
+  parser.reset();
+
+  status= parser.tryParseCmdLine("1 -s abc",buffer);
+  ASSERT_EQ(status.error,ErrorCode::lengthError);
+  parser.reset();
+
+  status= parser.tryParseCmdLine("-o 1",buffer);
+  ASSERT_EQ(status.error,ErrorCode::wrongCount);
+  ASSERT_EQ(status.arg,p1.info().get());
+  parser.reset();
+
+  status= parser.tryParseCmdLine("1 -o 1 2 cm",buffer);
+  ASSERT_EQ(status.error,ErrorCode::invalidChoice);
+  ASSERT_EQ(tokens[status.index],"2");
+  ASSERT_EQ(status.parser,&parser);
+  parser.reset();
+
+  status= parser.tryParseCmdLine("1 cmd",buffer);
+  ASSERT_EQ(status.error,ErrorCode::argumentRequired);
+  ASSERT_EQ(status.arg,r1.info().get());
+  ASSERT_EQ(status.parser,cmd.get());
+  parser.reset();
+
+  // the throwing API reports the same errors
+  ASSERT_THROW(parser.parseCmdLine("1 cmd"),ArgumentRequiredException<char>);
+  parser.reset();
+
+  int value= 7;
+  ASSERT_EQ(StringUtils::tryStrTo("x"sv,value),std::errc::invalid_argument);
+  ASSERT_EQ(value,7);
+  ASSERT_EQ(StringUtils::tryStrTo(L"-8"sv,value),std::errc());
+  ASSERT_EQ(value,-8);
+}
+
+TEST(common,parseResult)
+{
+  ArgumentParser parser;
+  auto p1 = parser.addPositional<int>("p1");
+  auto o1 = parser.addOptional<std::string,'*'>("-o");
+  auto cmd = parser.addSubParser("cmd");
+  auto r1 = cmd->addOptional<int>("-r");
+
+  ParseResult<char> result1, result2;
+  ASSERT_NO_THROW(parser.parseArgs({"1","-o","a","b"},result1));
+  ASSERT_NO_THROW(parser.parseArgs({"2","cmd","-r","3"},result2));
+
+  // args and parser are untouched
+  ASSERT_FALSE(p1.exists());
+  ASSERT_FALSE(o1.exists());
+  ASSERT_FALSE(cmd->exists());
+
+  ASSERT_EQ(p1.value(result1),1);
+  ASSERT_EQ(o1.values(result1),(std::vector<std::string>{"a","b"}));
+  ASSERT_FALSE(cmd->exists(result1));
+  ASSERT_FALSE(r1.exists(result1));
+
+  ASSERT_EQ(p1.value(result2),2);
+  ASSERT_FALSE(o1.exists(result2));
+  ASSERT_FALSE(o1.hasValue(result2));
+  ASSERT_TRUE(o1.values(result2).empty());
+  ASSERT_TRUE(cmd->exists(result2));
+  ASSERT_EQ(r1.value(result2),3);
+  ASSERT_EQ(r1.info()->valueAsString(result2),"3");
+
+  result2.clear();
+  ASSERT_FALSE(cmd->exists(result2));
+  ASSERT_FALSE(r1.exists(result2));
+
+  // one schema, several threads
+  std::vector<std::thread> threads;
+  std::vector<int> failures(4,0);
+  for(int t=0; t<4; ++t)
+  {
+    threads.emplace_back([&,t]()
+    {
+      ParseResult<char> result;
+      StringUtils::SplitBuffer<char> buffer;
+      for(int i=0; i<1000; ++i)
+      {
+        result.clear();
+        const std::string n= std::to_string(t*1000+i);
+        if(!parser.tryParseCmdLine(n+" cmd -r "+n,buffer,result) ||
+           p1.value(result)!=t*1000+i ||
+           r1.value(result)!=t*1000+i)
+          ++failures[t];
+      }
+    });
+  }
+  for(auto& thread: threads)
+    thread.join();
+  ASSERT_EQ(failures,std::vector<int>(4,0));
+}
+
+class CountingResource: public std::pmr::memory_resource
+{
+public:
+  std::size_t count= 0;
+  std::size_t bytes= 0;
+
+private:
+  void* do_allocate(std::size_t n, std::size_t alignment) override
+  {
+    ++count;
+    bytes+= n;
+    return std::pmr::new_delete_resource()->allocate(n,alignment);
+  }
+
+  void do_deallocate(void* p, std::size_t n, std::size_t alignment) override
+  {
+    bytes-= n;
+    std::pmr::new_delete_resource()->deallocate(p,n,alignment);
+  }
+
+  bool do_is_equal(const memory_resource& other)const noexcept override
+  {
+    return this==&other;
+  }
+};
+
+TEST(common,memoryResource)
+{
+  CountingResource resource;
+  {
+    ArgumentParser parser(&resource);
+    auto o1 = parser.addOptional<int>("-o","--option");
+    auto cmd = parser.addSubParser("cmd");
+    auto p1 = cmd->addPositional<std::string>("p1");
+    // tree, args, sub parser, lookup tables
+    ASSERT_GE(resource.count,4u);
+
+    ASSERT_NO_THROW(parser.parseCmdLine("--option 5 cmd abc"));
+    ASSERT_EQ(*o1,5);
+    ASSERT_EQ(*p1,"abc");
+  }
+  ASSERT_EQ(resource.bytes,0u);
+
+  std::pmr::monotonic_buffer_resource arena;
+  ArgumentParser parser(&arena);
+  auto o1 = parser.addOptional<int>("-o");
+  ASSERT_NO_THROW(parser.parseCmdLine("-o 6"));
+  ASSERT_EQ(*o1,6);
+}
+
+TEST(common,noAllocation)
+{
+  ArgumentParser parser;
+  auto o1 = parser.addOptional<int>("-o","--option");
+  auto f1 = parser.addOptional<bool>("-f");
+  auto o2 = parser.addOptional<int,'+'>("-i");
+  auto p1 = parser.addPositional<int,'*'>("p1");
+  auto cmd= parser.addSubParser("cmd");
+  auto s1 = cmd->addOptional<double>("-s");
+
+  // the buffers of the split, the token kinds
+  // and the result are kept by the next parses
+  StringUtils::SplitBuffer<char> buffer;
+  const std::string_view cmdLine= "1 2 3 --option 5 -f 1 -i 6 7 8 cmd -s 0.5";
+  for(int i=0; i<2; ++i)
+  {
+    parser.reset();
+    ASSERT_NO_THROW(parser.parseCmdLine(cmdLine,buffer));
+  }
+
+  const std::size_t before= allocationCount();
+  for(int i=0; i<100; ++i)
+  {
+    parser.reset();
+    parser.parseCmdLine(cmdLine,buffer);
+  }
+  ASSERT_EQ(allocationCount(),before);
+
+  ASSERT_EQ(*o1,5);
+  ASSERT_TRUE(*f1);
+  ASSERT_EQ(*s1,0.5);
+  ASSERT_EQ(o2->size(),3u);
+  ASSERT_EQ(p1->size(),3u);
+}
+
+TEST(common,conversionPaths)
+{
+  // the parse converts by ArgRecord::convert,
+  // same values and errors as the virtual call for all groups
+  using Conversion= detail::ArgConversion<char>;
+
+  ArgumentParser parser;
+  auto number = parser.addOptional<int>("-n");
+  auto numbers= parser.addOptional<double,'+'>("-d");
+  auto string = parser.addOptional<std::string>("-s");
+  auto strings= parser.addOptional<std::string,'+'>("-t");
+  number.setRange(0,100);
+  numbers.setRange(-1,1);
+  string.setMaxLength(3);
+  strings.setMinLength(2);
+  ASSERT_EQ(number.typeGroup(), TypeGroup::number);
+  ASSERT_EQ(numbers.typeGroup(),TypeGroup::numbers);
+  ASSERT_EQ(string.typeGroup(), TypeGroup::string);
+  ASSERT_EQ(strings.typeGroup(),TypeGroup::strings);
+
+  const std::vector<std::string> inputs{"1","50","101","-5","0.5","x","",
+                                        "abcd","ab","1e400"};
+  ParseResult<char> byRecord, byVirtual;
+  std::vector<ErrorCode> errors;
+  for(const auto& info: parser.optionals())
+  {
+    for(const auto& input: inputs)
+    {
+      const ErrorCode error= Conversion::byRecord(*info,input,byRecord);
+      ASSERT_EQ(error,Conversion::byVirtual(*info,input,byVirtual))
+          << info->fullName() << " " << input;
+      ASSERT_EQ(info->valueAsString(byRecord),info->valueAsString(byVirtual))
+          << info->fullName() << " " << input;
+      errors.push_back(error);
+    }
+  }
+
+  for(ErrorCode error: {ErrorCode::none,ErrorCode::outOfRange,
+                        ErrorCode::invalidArgument,ErrorCode::lengthError})
+    ASSERT_NE(std::find(errors.begin(),errors.end(),error),errors.end());
+
+  ASSERT_EQ(number.value(byRecord),50);
+  ASSERT_EQ(numbers.values(byRecord),numbers.values(byVirtual));
+  ASSERT_EQ(string.value(byRecord),"ab");
+  ASSERT_EQ(strings.values(byRecord),strings.values(byVirtual));
+}
+
+TEST(common,batchParser)
+{
+  ArgumentParser parser;
+  auto p1 = parser.addPositional<int>("p1");
+  auto o1 = parser.addOptional<int>("-o");
+  o1.setRange(0,100);
+
+  std::vector<std::string> lines;
+  for(int i=0; i<1000; ++i)
+    lines.push_back(std::to_string(i)+" -o "+std::to_string(i%150));
+
+  for(std::size_t threadCount: {1u,4u})
+  {
+    BatchParser<char> batch(parser,threadCount);
+    ASSERT_EQ(batch.threadCount(),threadCount);
+
+    for(int repeat=0; repeat<2; ++repeat)
+    {
+      const auto entries= batch.parse(lines);
+      ASSERT_EQ(entries.size(),lines.size());
+
+      for(int i=0; i<1000; ++i)
+      {
+        const auto& entry= entries[i];
+        ASSERT_EQ(p1.value(entry.result),i);
+        if(i%150<=100)
+        {
+          ASSERT_TRUE(entry.ok());
+          ASSERT_EQ(o1.value(entry.result),i%150);
+        }
+        else
+        {
+          ASSERT_EQ(entry.status.error,ErrorCode::outOfRange);
+          ASSERT_EQ(entry.status.index,2u);
+          ASSERT_THROW(std::rethrow_exception(entry.error),
+                       OutOfRangeException<char>);
+        }
+      }
+    }
+
+    // one entry per thread, reused by the next lines
+    const std::vector<std::string_view> views(lines.begin(),lines.end());
+    std::vector<int> values(lines.size(),-1);
+    std::atomic<std::size_t> failed{0};
+    batch.forEach(views,[&](std::size_t i, const BatchEntry<char>& entry)
+    {
+      values[i]= p1.value(entry.result);
+      if(entry.status.error==ErrorCode::outOfRange && entry.error)
+        ++failed;
+      else if(entry.ok() && o1.value(entry.result)==int(i%150))
+        values[i]+= 1000;
+    });
+    for(int i=0; i<1000; ++i)
+      ASSERT_EQ(values[i],i%150<=100 ? i+1000 : i);
+    ASSERT_EQ(failed,294u);
+  }
+  ASSERT_FALSE(p1.exists());
+}
+
+TEST(common,cmdLineReader)
+{
+  const std::string script=
+      "1 -o a\n"
+      "\n"
+      "2 -o \"b c\"\r\n"
+      "3 -o \"multi\nline\"\n"
+      "4";
+
+  ArgumentParser parser;
+  auto p1 = parser.addPositional<int>("p1");
+  auto o1 = parser.addOptional<std::string>("-o");
+
+  // small blocks split quoted tokens between reads
+  for(std::size_t blockSize: {1u,3u,7u,4096u})
+  {
+    std::istringstream stream(script);
+    CmdLineReader<char> reader(stream,blockSize);
+
+    std::vector<std::string> lines;
+    std::string_view line;
+    while(reader.nextLine(line))
+      lines.emplace_back(line);
+    ASSERT_EQ(lines,(std::vector<std::string>{
+      "1 -o a","","2 -o \"b c\"","3 -o \"multi\nline\"","4"}));
+
+    std::istringstream stream2(script);
+    CmdLineReader<char> reader2(stream2,blockSize);
+    ParseResult<char> result;
+    ParseStatus<char> status;
+    std::vector<std::string> values;
+    while(reader2.parseNext(parser,result,status))
+    {
+      ASSERT_TRUE(status.ok());
+      if(o1.exists(result))
+        values.push_back(std::to_string(p1.value(result))+o1.value(result));
+    }
+    ASSERT_EQ(values,(std::vector<std::string>{"1a","2b c","3multi\nline"}));
+  }
+
+  std::istringstream tooLong(std::string(100,'x'));
+  CmdLineReader<char> reader(tooLong,8,16);
+  std::string_view line;
+  ASSERT_THROW(reader.nextLine(line),std::length_error);
+
+  std::wistringstream wstream(L"w1\nw2");
+  CmdLineReader<wchar_t> wreader(wstream,1);
+  std::wstring_view wline;
+  ASSERT_TRUE(wreader.nextLine(wline));
+  ASSERT_EQ(wline,L"w1");
+  ASSERT_TRUE(wreader.nextLine(wline));
+  ASSERT_EQ(wline,L"w2");
+  ASSERT_FALSE(wreader.nextLine(wline));
+
+#ifndef _WIN32
+  FILE* file= std::tmpfile();
+  ASSERT_NE(file,nullptr);
+  std::fputs("5 -o fd\n6",file);
+  std::fflush(file);
+  std::rewind(file);
+
+  CmdLineReader<char> fdReader(fileno(file),2);
+  const auto* tokens= fdReader.nextTokens();
+  ASSERT_NE(tokens,nullptr);
+  ASSERT_EQ(*tokens,(std::vector<std::string_view>{"5","-o","fd"}));
+  tokens= fdReader.nextTokens();
+  ASSERT_NE(tokens,nullptr);
+  ASSERT_EQ(*tokens,(std::vector<std::string_view>{"6"}));
+  ASSERT_EQ(fdReader.nextTokens(),nullptr);
+  std::fclose(file);
+#endif
+}
+
+TEST(common,responseFiles)
+{
+  namespace fs= std::filesystem;
+  const fs::path dir= fs::temp_directory_path()/"argparse_response_files";
+  fs::create_directories(dir);
+
+  const auto write= [&](const char* name, const char* text)
+  {
+    std::ofstream(dir/name)<<text;
+    return "@"+(dir/name).string();
+  };
+
+  const std::string b= write("b.rsp","3\n-o \"x y\"");
+  const std::string a= write("a.rsp",("1 \"two words\"\n"+b).c_str());
+  const std::string empty= write("empty.rsp","");
+  const std::string self= (dir/"self.rsp").string();
+  write("self.rsp",("@"+self).c_str());
+
+  ArgumentParser parser;
+  auto p1 = parser.addPositional<std::string,'*'>("p1");
+  auto o1 = parser.addOptional<std::string>("-o");
+
+  ResponseFiles files;
+  const std::vector<std::string_view> args{"0",a,empty,"@","5"};
+  ASSERT_EQ(files.expand(args),(std::vector<std::string_view>{
+                "0","1","two words","3","-o","x y","@","5"}));
+
+  ASSERT_NO_THROW(parser.parseArgs(files.expand({"0",a,empty})));
+  ASSERT_EQ(*p1,(std::vector<std::string>{"0","1","two words","3"}));
+  ASSERT_EQ(*o1,"x y");
+
+  try
+  {
+    files.expand({"@"+self});
+    FAIL();
+  }
+  catch(const ResponseFileException<char>& e)
+  {
+    ASSERT_EQ(e.reason(),ResponseFileException<char>::Reason::tooDeep);
+    ASSERT_EQ(e.fileName(),self);
+  }
+
+  ResponseFiles flat('@',1);
+  ASSERT_NO_THROW(flat.expand({b}));
+  ASSERT_THROW(flat.expand({a}),ResponseFileException<char>);
+
+  try
+  {
+    files.expand({"@"+(dir/"missing.rsp").string()});
+    FAIL();
+  }
+  catch(const ResponseFileException<char>& e)
+  {
+    ASSERT_EQ(e.reason(),ResponseFileException<char>::Reason::cannotOpen);
+    ASSERT_EQ(e.error(),std::errc::no_such_file_or_directory);
+  }
+
+  fs::remove_all(dir);
+}
+
+TEST(common,lazyConversion)
+{
+  ArgumentParser parser;
+  parser.setLazyConversion(true);
+  auto p1 = parser.addPositional<int,'*'>("p1");
+  auto o1 = parser.addOptional<int>("-o");
+  auto o2 = parser.addOptional<std::string>("-s");
+  auto o3 = parser.addOptional<double,'+'>("-d");
+  o1.setRange(0,10);
+  o2.setMaxLength(3);
+
+  // conversion errors are not reported by the parse
+  ParseResult<char> result;
+  StringUtils::SplitBuffer<char> buffer;
+  ASSERT_TRUE(parser.tryParseCmdLine("1 x 3 -o 1 -o 11 -s abcd -d 1.5",
+                                     buffer,result));
+  ASSERT_TRUE(p1.exists(result));
+  ASSERT_TRUE(p1.hasValue(result));
+  ASSERT_TRUE(o1.exists(result));
+  ASSERT_TRUE(o2.exists(result));
+
+  // but by the first read, the last single value wins
+  ASSERT_THROW(p1.values(result),InvalidArgumentException<char>);
+  ASSERT_THROW(p1.values(result),InvalidArgumentException<char>);
+  ASSERT_THROW(o1.value(result),OutOfRangeException<char>);
+  ASSERT_THROW(o2.value(result),LengthErrorException<char>);
+  ASSERT_EQ(o3.values(result),std::vector<double>{1.5});
+
+  // tokens are kept by the result, the command line is a temporary
+  ASSERT_NO_THROW(parser.parseCmdLine(std::string("4 5 -o 6 -s ab -d 2 3")));
+  ASSERT_EQ(*p1,(std::vector<int>{4,5}));
+  ASSERT_EQ(*o1,6);
+  ASSERT_EQ(*o2,"ab");
+  ASSERT_EQ(*o3,(std::vector<double>{2,3}));
+  ASSERT_EQ(o3.info()->valueAsString(),"2.000000, 3.000000");
+  parser.reset();
+
+  ASSERT_FALSE(o1.exists());
+  ASSERT_FALSE(o1.hasValue());
+
+  parser.setLazyConversion(false);
+  ASSERT_THROW(parser.parseCmdLine("x"),InvalidArgumentException<char>);
+}
+
+TEST(common,lazyReparse)
+{
+  ArgumentParser parser;
+  parser.setLazyConversion(true);
+  auto o1 = parser.addOptional<int>("-o");
+  auto o2 = parser.addOptional<int>("-s");
+  auto o3 = parser.addOptional<int,'+'>("-i");
+
+  // tokens of the previous parses are kept while not converted
+  ParseResult<char> result;
+  ASSERT_TRUE(parser.tryParseArgs({"-o","1","-i","2","3"},result));
+  ASSERT_TRUE(parser.tryParseArgs({"-s","4"},result));
+  ASSERT_EQ(o1.value(result),1);
+  ASSERT_EQ(o2.value(result),4);
+  ASSERT_EQ(o3.values(result),(std::vector<int>{2,3}));
+
+  // the text of the previous parses is reused, not accumulated
+  StringUtils::SplitBuffer<char> buffer;
+  const auto parse= [&](int i)
+  {
+    const std::string cmdLine= "-o "+std::to_string(i)+" -s "+std::to_string(i+1);
+    ASSERT_TRUE(parser.tryParseCmdLine(cmdLine,buffer,result));
+    ASSERT_EQ(o1.value(result),i);
+    ASSERT_EQ(o2.value(result),i+1);
+  };
+  for(int i=0; i<10; ++i)
+    parse(100+i);
+
+  const std::size_t before= allocationCount();
+  for(int i=0; i<1000; ++i)
+    parse(100+i%10);
+  ASSERT_EQ(allocationCount(),before);
+  ASSERT_EQ(o3.values(result),(std::vector<int>{2,3}));
+}
+
+TEST(common,parseStatsDisabled)
+{
+  // the default build records nothing, see tests/stats_test
+  ASSERT_FALSE(ParseStats::enabled);
+
+  ArgumentParser parser;
+  parser.addOptional<int>("-o");
+
+  ParseResult<char> result;
+  ASSERT_TRUE(parser.tryParseArgs({"-o","1"},result));
+  ASSERT_EQ(result.stats()[ParsePhase::conversion].count,0u);
+  ASSERT_EQ(result.stats().totalTime().count(),0);
+}
+//------------------------------------------------------------------
+TEST(common,helpCache)
+{
+  ArgumentParser parser;
+  auto o1 = parser.addOptional<int>("-o");
+  auto sub= parser.addSubParser("cmd");
+  auto s1 = sub->addOptional<int>("-s");
+
+  // same text until a change
+  const std::string& usage= parser.usage();
+  ASSERT_EQ(&usage,&parser.usage());
+  const std::string help= parser.help(true);
+  ASSERT_EQ(&parser.help(true),&parser.help(true));
+  ASSERT_EQ(parser.help(false),parser.help(false));
+
+  o1.setHelp("option");
+  ASSERT_NE(parser.help(true),help);
+  ASSERT_NE(parser.help(true).find("-o -O option"),std::string::npos);
+
+  // changes of sub parsers invalidate the recursive help of the parents
+  s1.setHelp("sub option");
+  ASSERT_NE(parser.help(true).find("sub option"),std::string::npos);
+  ASSERT_EQ(parser.help(false).find("sub option"),std::string::npos);
+
+  sub->setSubParserHelp("command");
+  ASSERT_NE(parser.help().find("cmd command"),std::string::npos);
+
+  parser.addPositional<int>("p1");
+  ASSERT_EQ(parser.usage(),"[-o -O] p1 {'cmd'}");
+  parser.removeSubParsers();
+  ASSERT_EQ(parser.usage(),"[-o -O] p1");
+
+  // a large level is cached alone
+  const std::string& deep= parser.help(false,10000);
+  ASSERT_EQ(deep.substr(0,40004),std::string(40000,' ')+"posi");
+
+  // concurrent first calls build the texts once
+  o1.setHelp("changed");
+  std::vector<const std::string*> usages(4), helps(4);
+  std::vector<std::thread> threads;
+  for(std::size_t i=0; i<4; ++i)
+  {
+    threads.emplace_back([&,i]
+    {
+      usages[i]= &parser.usage();
+      helps[i]= &parser.help();
+    });
+  }
+  for(auto& thread: threads)
+    thread.join();
+  for(std::size_t i=0; i<4; ++i)
+  {
+    ASSERT_EQ(usages[i],&parser.usage());
+    ASSERT_EQ(helps[i],&parser.help());
+  }
+  ASSERT_NE(parser.help().find("changed"),std::string::npos);
+}
+//------------------------------------------------------------------
+TEST(common,helpWriter)
+{
+  ArgumentParser parser;
+  auto o1 = parser.addOptional<int,'+'>("-o","--opt");
+  o1.setHelp("option");
+  parser.addPositional<int>("p1");
+  auto sub= parser.addSubParser("cmd");
+  sub->addOptional<int>("-s");
+
+  std::ostringstream os;
+  parser.writeHelp(os,true);
+  ASSERT_EQ(os.str(),parser.help(true));
+
+  std::ostringstream usage;
+  parser.writeUsage(usage);
+  ASSERT_EQ(usage.str(),parser.usage());
+
+  std::string text("usage: ");
+  parser.writeUsage(std::back_inserter(text));
+  ASSERT_EQ(text,"usage: "+parser.usage());
+
+  std::wstringstream ws;
+  ArgParse::ArgumentParser<wchar_t> wparser;
+  wparser.addOptional<int>(L"-w");
+  wparser.writeUsage(ws);
+  ASSERT_EQ(ws.str(),L"[-w -W]");
+}
+//------------------------------------------------------------------
+TEST(common,resetEpoch)
+{
+  ArgumentParser parser;
+  auto o1 = parser.addOptional<int>("-o");
+  auto o2 = parser.addOptional<int,'+'>("-i");
+  auto sub= parser.addSubParser("cmd");
+  auto s1 = sub->addOptional<int>("-s");
+
+  for(int i=0; i<3; ++i)
+  {
+    ASSERT_NO_THROW(parser.parseCmdLine("-o 1 -i 2 3 cmd -s 4"));
+    ASSERT_EQ(*o1,1);
+    ASSERT_EQ(*o2,(std::vector<int>{2,3}));
+    ASSERT_TRUE(sub->exists());
+
+    // sub parser resets its own args only
+    sub->reset();
+    ASSERT_FALSE(sub->exists());
+    ASSERT_FALSE(s1.exists());
+    ASSERT_TRUE(o1.exists());
+
+    parser.reset();
+    ASSERT_FALSE(o1.exists());
+    ASSERT_FALSE(o1.hasValue());
+    ASSERT_TRUE(o2.values().empty());
+  }
+
+  // values of the previous epoch are not appended to
+  ASSERT_NO_THROW(parser.parseCmdLine("-i 5"));
+  ASSERT_EQ(*o2,(std::vector<int>{5}));
+
+  ParseResult<char> result;
+  ASSERT_TRUE(parser.tryParseArgs({"-o","7"},result));
+  o1.info()->reset(result);
+  ASSERT_FALSE(o1.exists(result));
+  ASSERT_TRUE(parser.tryParseArgs({"-o","8"},result));
+  ASSERT_EQ(o1.value(result),8);
+  parser.reset(result);
+  ASSERT_FALSE(o1.exists(result));
+  ASSERT_EQ(*o2,(std::vector<int>{5}));
+}
+//------------------------------------------------------------------
+static constexpr auto staticSchema= schema::make(
+    schema::positional<std::string>("input"),
+    schema::positional<int,'*'>("rest"),
+    schema::optional<int>("-n","--number").required().help("number"),
+    schema::optional<double,'+'>("-w","--weights"),
+    schema::optional<std::string>("-s"));
+
+TEST(common,staticParser)
+{
+  StaticParser<staticSchema> parser;
+
+  const char* argv[]= {"in","1","2","-w","0.5","1.5","-n","3","-s","x","--","4"};
+  ASSERT_TRUE(parser.tryParseArgs(std::size(argv),argv));
+  ASSERT_EQ(*parser.value<0>(),"in");
+  const auto rest= parser.values<1>();
+  ASSERT_EQ(std::vector<int>(rest.begin(),rest.end()),(std::vector<int>{1,2,4}));
+  ASSERT_EQ(parser.value<2>(),3);
+  ASSERT_EQ(parser.count<3>(),2u);
+  ASSERT_EQ(parser.values<3>()[1],1.5);
+  ASSERT_EQ(*parser.value<4>(),"x");
+
+  // same errors as ArgumentParser, values are read from
+  // the tokens, which must outlive the reads
+  const auto status= [&](const std::vector<std::string_view>& args)
+  {
+    return parser.tryParseArgs(args.data(),args.size());
+  };
+  ASSERT_EQ(status({"in"}).error,ErrorCode::argumentRequired);
+  ASSERT_EQ(status({"in"}).arg,2u);
+  ASSERT_EQ(status({"in","-n","x"}).error,ErrorCode::invalidArgument);
+  ASSERT_EQ(status({"in","-n","x"}).index,2u);
+  ASSERT_EQ(status({"in","-n","1","-w"}).error,ErrorCode::wrongCount);
+  ASSERT_EQ(status({"in","-n","1","-w"}).index,3u);
+  ASSERT_EQ(status({"in","-n","1","-q"}).error,ErrorCode::unrecognizedArguments);
+  ASSERT_EQ(status({"in","-n","99999999999"}).error,ErrorCode::outOfRange);
+
+  const std::vector<std::string_view> args{"in","-n","1","-n","2"};
+  ASSERT_TRUE(status(args));
+  ASSERT_EQ(parser.value<2>(),2);
+  ASSERT_FALSE(parser.exists<3>());
+  ASSERT_FALSE(parser.value<4>().has_value());
+
+  ArgumentParser runtime;
+  runtime.addPositional<std::string>("input");
+  runtime.addPositional<int,'*'>("rest");
+  auto number= runtime.addOptional<int>("-n","--number");
+  number.setRequired(true);
+  number.setHelp("number");
+  runtime.addOptional<double,'+'>("-w","--weights");
+  runtime.addOptional<std::string>("-s");
+
+  std::string usage, help;
+  parser.writeUsage(std::back_inserter(usage));
+  parser.writeHelp(std::back_inserter(help));
+  ASSERT_EQ(usage,runtime.usage());
+  ASSERT_EQ(help,runtime.help());
+}
+//------------------------------------------------------------------
+TEST(common,perfectHash)
+{
+  using detail::hashString;
+
+  constexpr std::array<std::uint64_t,4> keys{
+      hashString("-a"sv),hashString("--all"sv),
+      hashString("-b"sv),hashString("--bell"sv)};
+  constexpr auto small= detail::PerfectHash<4>::build(keys);
+  static_assert(small.ok() && small.verify(keys));
+
+  std::array<std::uint64_t,1000> hashes;
+  for(std::size_t i=0; i<hashes.size(); ++i)
+    hashes[i]= hashString(std::string_view("--option"+std::to_string(i)));
+
+  const auto hash= detail::PerfectHash<1000>::build(hashes);
+  ASSERT_TRUE(hash.ok());
+  ASSERT_TRUE(hash.verify(hashes));
+
+  // equal keys can not be separated
+  hashes[1]= hashes[0];
+  ASSERT_FALSE(detail::PerfectHash<1000>::build(hashes).ok());
+}
+//------------------------------------------------------------------
 TEST(common,parseArgs)
 {
   const char* argv[] =
@@ -682,6 +1553,322 @@ TEST(positional_mixed6,n5) // *+*
   ASSERT_EQ(*p3,(std::vector<int>{}));
 }
 
+TEST(optional,lookup)
+{
+  ArgumentParser parser;
+  for(int i=0; i<1000; ++i)
+    parser.addOptional<int>("-o"+std::to_string(i),"--option"+std::to_string(i));
+
+  auto o1 = parser.addOptional<int>("-a","--alpha","/a");
+
+  ASSERT_NO_THROW(parser.parseCmdLine("--option999 1 /a 2 -o0 3"));
+  ASSERT_TRUE(o1.exists());
+  ASSERT_EQ(*o1,2);
+  parser.clear();
+
+  auto o2 = parser.addOptional<int>("-a","--alpha");
+  ASSERT_THROW(parser.parseCmdLine("--option999 1"),
+               UnrecognizedArgumentsException<char>);
+  parser.reset();
+
+  ASSERT_NO_THROW(parser.parseCmdLine("--alpha 5"));
+  ASSERT_EQ(*o2,5);
+}
+
+TEST(optional,removeArguments)
+{
+  CountingResource resource;
+  ArgumentParser parser(&resource);
+  auto o1 = parser.addOptional<int>("-o","--option");
+  auto p1 = parser.addPositional<int,'?'>("p1");
+
+  // required is read by the next parse
+  ASSERT_NO_THROW(parser.parseCmdLine("1"));
+  o1.setRequired(true);
+  parser.reset();
+  ASSERT_THROW(parser.parseCmdLine("1"),ArgumentRequiredException<char>);
+  parser.reset();
+  ASSERT_NO_THROW(parser.parseCmdLine("1 --option 2"));
+  ASSERT_EQ(*o1,2);
+  ASSERT_EQ(*p1,1);
+
+  // new args take the slots of the removed ones,
+  // the values and the handles of the removed args do not reach them
+  parser.removeAllArguments();
+  auto o2 = parser.addOptional<int>("-o","--other");
+  ASSERT_FALSE(o2.exists());
+  ASSERT_FALSE(o1.exists());
+  ASSERT_TRUE(o1.info()->isRequired());
+  ASSERT_FALSE(o2.info()->isRequired());
+  o1.setRequired(true);
+  ASSERT_NO_THROW(parser.parseCmdLine(""));
+  parser.reset();
+
+  // option strings of the new args only
+  ASSERT_NO_THROW(parser.parseCmdLine("--other 3"));
+  ASSERT_EQ(*o2,3);
+  parser.reset();
+  ASSERT_NO_THROW(parser.parseCmdLine("-o 4"));
+  ASSERT_EQ(*o2,4);
+  parser.reset();
+  ASSERT_THROW(parser.parseCmdLine("--option 5"),
+               UnrecognizedArgumentsException<char>);
+  parser.reset();
+  parser.setAllowAbbrev(true);
+  ASSERT_NO_THROW(parser.parseCmdLine("--oth 6"));
+  ASSERT_EQ(*o2,6);
+  parser.reset();
+
+  // the tree does not grow by repeated removes
+  std::size_t bytes= 0;
+  for(int i=0; i<100; ++i)
+  {
+    if(i==10)
+      bytes= resource.bytes;
+
+    parser.removeAllArguments();
+    auto o3 = parser.addOptional<int>("--loop");
+    auto p3 = parser.addPositional<int,'?'>("p3");
+    parser.reset();
+    ASSERT_NO_THROW(parser.parseCmdLine("7 --loop 8"));
+    ASSERT_EQ(*o3,8);
+    ASSERT_EQ(*p3,7);
+  }
+  ASSERT_EQ(resource.bytes,bytes);
+}
+
+TEST(optional,abbrev)
+{
+  ArgumentParser parser;
+  auto verbose  = parser.addOptional<int>("-v","--verbose");
+  auto verbosity= parser.addOptional<int>("--verbosity");
+  auto output   = parser.addOptional<std::string>("-o","--output");
+  auto color    = parser.addOptional<int>("--color","--colour");
+
+  ASSERT_THROW(parser.parseCmdLine("--out x"),
+               UnrecognizedArgumentsException<char>);
+  parser.reset();
+
+  parser.setAllowAbbrev(true);
+  ASSERT_NO_THROW(parser.parseCmdLine("--out x --verbosi 2 --col 3 --verbose 1"));
+  ASSERT_EQ(*output,"x");
+  ASSERT_EQ(*verbosity,2);
+  ASSERT_EQ(*color,3);
+  ASSERT_EQ(*verbose,1);
+  parser.reset();
+
+  // single prefix char options are not abbreviated
+  ASSERT_THROW(parser.parseCmdLine("-verb 1"),
+               UnrecognizedArgumentsException<char>);
+  parser.reset();
+
+  const auto status= parser.tryParseCmdLine("--out x --verb 1");
+  ASSERT_EQ(status.error,ErrorCode::ambiguousOption);
+  ASSERT_EQ(status.index,2u);
+  try
+  {
+    parser.parseCmdLine("--verb 1");
+    FAIL();
+  }
+  catch(const AmbiguousOptionException<char>& e)
+  {
+    ASSERT_EQ(e.value(),"--verb");
+    ASSERT_EQ(e.candidates(),(std::vector<std::string>{"--verbose","--verbosity"}));
+  }
+  parser.reset();
+
+  // args added later are found too
+  auto zeta= parser.addOptional<int>("--zeta");
+  ASSERT_NO_THROW(parser.parseCmdLine("--z 4"));
+  ASSERT_EQ(*zeta,4);
+  parser.reset();
+
+  // unique prefixes of many options
+  parser.clear();
+  for(int i=0; i<1000; ++i)
+    parser.addOptional<int>("--option"+std::to_string(i)+"x");
+  auto last= parser.addOptional<int>("--last");
+  ASSERT_NO_THROW(parser.parseCmdLine("--option999 1 --l 2"));
+  ASSERT_EQ(*last,2);
+  ASSERT_EQ(parser.tryParseCmdLine("--option9 1").error,ErrorCode::ambiguousOption);
+}
+
+TEST(optional,suggestions)
+{
+  ArgumentParser parser;
+  parser.addOptional<int>("-v","--verbose");
+  parser.addOptional<int>("--verbosity");
+  parser.addOptional<std::string>("-o","--output");
+
+  try
+  {
+    parser.parseCmdLine("--verbse 1");
+    FAIL();
+  }
+  catch(const UnrecognizedArgumentsException<char>& e)
+  {
+    ASSERT_EQ(e.suggestions(),(std::vector<std::string>{"--verbose"}));
+    ASSERT_EQ(e.what(),"unrecognized arguments: '--verbse', '1'; "
+                       "did you mean '--verbose'?");
+  }
+
+  // nothing close, values are not options
+  try
+  {
+    parser.parseCmdLine("--zzzzzzzz");
+    FAIL();
+  }
+  catch(const UnrecognizedArgumentsException<char>& e)
+  {
+    ASSERT_TRUE(e.suggestions().empty());
+    ASSERT_EQ(e.what(),"unrecognized arguments: '--zzzzzzzz'");
+  }
+
+  // index follows the schema
+  parser.addOptional<int>("--verbatim");
+  parser.setSuggestions(2,3);
+  try
+  {
+    parser.parseCmdLine("--verbaxx");
+    FAIL();
+  }
+  catch(const UnrecognizedArgumentsException<char>& e)
+  {
+    ASSERT_EQ(e.suggestions(),(std::vector<std::string>{"--verbatim","--verbose"}));
+  }
+
+  parser.setSuggestions(0);
+  try
+  {
+    parser.parseCmdLine("--verbse 1");
+    FAIL();
+  }
+  catch(const UnrecognizedArgumentsException<char>& e)
+  {
+    ASSERT_TRUE(e.suggestions().empty());
+  }
+}
+
+TEST(subParsers,suggestions)
+{
+  ArgumentParser parser;
+  parser.addOptional<std::string>("-o","--output");
+  parser.addSubParser("commit");
+  parser.addSubParser("checkout");
+
+  try
+  {
+    parser.parseCmdLine("-o x comit");
+    FAIL();
+  }
+  catch(const InvalidChoiceException<char>& e)
+  {
+    ASSERT_EQ(e.suggestions(),(std::vector<std::string>{"commit"}));
+    ASSERT_EQ(e.what(),"invalid choice: 'comit' (choose from 'commit', 'checkout'); "
+                       "did you mean 'commit'?");
+  }
+
+  // unknown options before a sub parser
+  try
+  {
+    parser.parseCmdLine("--outptu x");
+    FAIL();
+  }
+  catch(const InvalidChoiceException<char>& e)
+  {
+    ASSERT_EQ(e.suggestions(),(std::vector<std::string>{"--output"}));
+  }
+
+  try
+  {
+    parser.parseCmdLine("chekout");
+    FAIL();
+  }
+  catch(const UnrecognizedArgumentsException<char>& e)
+  {
+    ASSERT_EQ(e.suggestions(),(std::vector<std::string>{"checkout"}));
+  }
+}
+
+TEST(optional,bkTree)
+{
+  std::vector<std::string> words;
+  for(int i=0; i<2000; ++i)
+    words.push_back("--opt"+std::to_string(i*7919%10007));
+
+  detail::BkTree<char> tree;
+  for(const auto& word: words)
+    tree.insert(word);
+
+  // same matches as a sweep over all words
+  std::vector<std::size_t> row;
+  for(std::string query: {"--opt123","--op1234","-opt99","--xyz"})
+  {
+    std::vector<std::pair<std::size_t,std::string>> expected;
+    for(const auto& word: words)
+    {
+      const std::size_t d= detail::editDistance<char>(query,word,row);
+      if(d<=2)
+        expected.emplace_back(d,word);
+    }
+    std::sort(expected.begin(),expected.end());
+    expected.resize(std::min<std::size_t>(expected.size(),5));
+
+    const auto matches= tree.find(query,2,5);
+    ASSERT_EQ(matches.size(),expected.size());
+    for(std::size_t i=0; i<matches.size(); ++i)
+    {
+      ASSERT_EQ(matches[i].distance,expected[i].first);
+      ASSERT_EQ(matches[i].word,expected[i].second);
+    }
+  }
+}
+
+TEST(optional,separator)
+{
+  ArgumentParser parser;
+  auto p1 = parser.addPositional<std::string,'*'>("p1");
+  auto o1 = parser.addOptional<int>("-o");
+  auto cmd = parser.addSubParser("cmd");
+
+  ASSERT_NO_THROW(parser.parseCmdLine("a -o 1 -- -b cmd c"));
+  ASSERT_EQ(*p1,(std::vector<std::string>{"a","-b","cmd","c"}));
+  ASSERT_EQ(*o1,1);
+  ASSERT_FALSE(cmd->exists());
+  parser.reset();
+
+  ASSERT_NO_THROW(parser.parseCmdLine("-- -o"));
+  ASSERT_EQ(*p1,(std::vector<std::string>{"-o"}));
+  ASSERT_FALSE(o1.exists());
+  parser.reset();
+
+  ASSERT_NO_THROW(parser.parseCmdLine("a b --"));
+  ASSERT_EQ(*p1,(std::vector<std::string>{"a","b"}));
+}
+
+TEST(positional,many)
+{
+  // values are distributed over thousands of positionals,
+  // the linear cost is checked by stats_test and argparse_bench
+  for(int count: {2000,8000})
+  {
+    ArgumentParser parser;
+    std::vector<IntArg<'?'>> args;
+    for(int i=0; i<count; ++i)
+      args.push_back(parser.addPositional<int,'?'>("p"+std::to_string(i)));
+    auto last = parser.addPositional<int,'+'>("last");
+
+    std::vector<std::string> values;
+    for(int i=0; i<count+2; ++i)
+      values.push_back(std::to_string(i));
+
+    ASSERT_NO_THROW(parser.parseArgs(values));
+    ASSERT_EQ(*args.front(),0);
+    ASSERT_EQ(*args.back(),count-1);
+    ASSERT_EQ(*last,(std::vector<int>{count,count+1}));
+  }
+}
+
 TEST(subParsers,t1)
 {
   ArgumentParser parser;
@@ -709,6 +1896,73 @@ TEST(subParsers,t1)
 
 
 
+TEST(subParsers,remove)
+{
+  CountingResource resource;
+  ArgumentParser parser(&resource);
+  auto o1= parser.addOptional<int>("-o");
+
+  // a removed sub parser still used becomes the root of its own tree
+  auto held= parser.addSubParser("held");
+  auto h1= held->addOptional<int>("-h");
+  ASSERT_NO_THROW(parser.parseCmdLine("held -h 1"));
+  ASSERT_EQ(*h1,1);
+  parser.removeSubParsers();
+  ASSERT_FALSE(h1.exists());
+  ASSERT_NO_THROW(held->parseCmdLine("-h 2"));
+  ASSERT_EQ(*h1,2);
+  parser.reset();
+  ASSERT_FALSE(parser.tryParseCmdLine("held -h 1"));
+  parser.reset();
+
+  // the slots of removed sub parsers and of their args are reused
+  std::size_t bytes= 0;
+  for(int i=0; i<100; ++i)
+  {
+    if(i==10)
+      bytes= resource.bytes;
+
+    parser.removeSubParsers();
+    auto cmd= parser.addSubParser("cmd");
+    auto s1 = cmd->addOptional<int>("-s");
+    auto p1 = cmd->addPositional<int>("p");
+    parser.reset();
+    ASSERT_NO_THROW(parser.parseCmdLine("-o 1 cmd 2 -s 3"));
+    ASSERT_EQ(*o1,1);
+    ASSERT_EQ(*s1,3);
+    ASSERT_EQ(*p1,2);
+  }
+  ASSERT_EQ(resource.bytes,bytes);
+}
+
+TEST(subParsers,index)
+{
+  ArgumentParser parser;
+  auto p1 = parser.addPositional<std::string,'*'>("p1");
+  for(int i=0; i<300; ++i)
+    parser.addSubParser("cmd"+std::to_string(i));
+
+  auto cmd = parser.addSubParser("last");
+  auto p2 = cmd->addPositional<int>("p2");
+
+  ASSERT_NO_THROW(parser.parseCmdLine("a b last 7"));
+  ASSERT_EQ(*p1,(std::vector<std::string>{"a","b"}));
+  ASSERT_TRUE(cmd->exists());
+  ASSERT_EQ(*p2,7);
+  parser.reset();
+
+  parser.removeSubParsers();
+  ASSERT_NO_THROW(parser.parseCmdLine("a b last 7"));
+  ASSERT_EQ(*p1,(std::vector<std::string>{"a","b","last","7"}));
+  parser.reset();
+
+  auto cmd2 = parser.addSubParser("cmd0");
+  auto p3 = cmd2->addPositional<int>("p3");
+  ASSERT_NO_THROW(parser.parseCmdLine("a cmd0 8"));
+  ASSERT_TRUE(cmd2->exists());
+  ASSERT_EQ(*p3,8);
+}
+
 int main(int argc, char *argv[])
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "../../ArgParse/ArgumentParser.h"
+
+using namespace ArgParse;
+
+// Tests of the parser built with ARGPARSE_INSTRUMENTATION
+//------------------------------------------------------------------
+TEST(common,parseStats)
+{
+  ASSERT_TRUE(ParseStats::enabled);
+
+  ArgumentParser<char> parser;
+  auto p1 = parser.addPositional<int,'*'>("p1");
+  auto o1 = parser.addOptional<int>("-o");
+  auto o2 = parser.addOptional<int,'+'>("-i");
+  auto sub= parser.addSubParser("cmd");
+  auto s1 = sub->addOptional<int>("-s");
+
+  ParseResult<char> result;
+  StringUtils::SplitBuffer<char> buffer;
+  ASSERT_TRUE(parser.tryParseCmdLine("1 2 -o 3 -i 4 5 cmd -s 6",buffer,result));
+  ASSERT_EQ(s1.value(result),6);
+
+  const ParseStats& stats= result.stats();
+  ASSERT_EQ(stats[ParsePhase::tokenize].count,10u);
+  ASSERT_EQ(stats[ParsePhase::classify].count,10u);
+  ASSERT_EQ(stats[ParsePhase::subParser].count,1u);
+  ASSERT_EQ(stats[ParsePhase::optionalLookup].count,3u);
+  ASSERT_EQ(stats[ParsePhase::positional].count,3u);
+  ASSERT_EQ(stats[ParsePhase::conversion].count,6u);
+  ASSERT_EQ(stats[ParsePhase::requiredCheck].count,3u);
+  ASSERT_EQ(stats[ParsePhase::other].count,1u);
+  ASSERT_GT(stats.totalTime().count(),0);
+
+  // each parse starts from zero, sums are made by the caller
+  ParseStats total;
+  total+= stats;
+  ASSERT_TRUE(parser.tryParseArgs({"7","-o","8"},result));
+  ASSERT_EQ(result.stats()[ParsePhase::tokenize].count,0u);
+  ASSERT_EQ(result.stats()[ParsePhase::conversion].count,2u);
+  total+= result.stats();
+  ASSERT_EQ(total[ParsePhase::conversion].count,8u);
+  ASSERT_EQ(total[ParsePhase::other].count,2u);
+
+  result.clear();
+  ASSERT_EQ(result.stats()[ParsePhase::other].count,0u);
+}
+//------------------------------------------------------------------
+TEST(positional,scaling)
+{
+  // each positional is visited and each value is converted once,
+  // the work grows linearly with the count of positionals
+  for(std::size_t count: {2000u,8000u})
+  {
+    ArgumentParser<char> parser;
+    for(std::size_t i=0; i<count; ++i)
+      parser.addPositional<int,'?'>("p"+std::to_string(i));
+    parser.addPositional<int,'+'>("last");
+
+    std::vector<std::string> values;
+    for(std::size_t i=0; i<count+2; ++i)
+      values.push_back(std::to_string(i));
+
+    ParseResult<char> result;
+    const ArgumentParser<char>::StringViews views(values.begin(),values.end());
+    ASSERT_TRUE(parser.tryParseArgs(views,result));
+
+    const ParseStats& stats= result.stats();
+    ASSERT_EQ(stats[ParsePhase::positional].count,(count+1)+(count+2));
+    ASSERT_EQ(stats[ParsePhase::conversion].count,count+2);
+    ASSERT_EQ(stats[ParsePhase::optionalLookup].count,0u);
+    ASSERT_EQ(stats[ParsePhase::other].count,1u);
+  }
+}
+//------------------------------------------------------------------